@@ -52,12 +52,15 @@ sub mode_sanity {
                   or (@{$mode} == 3 and $mode->[0] =~ m|^v[35]$|)))) {
         return (undef, "invalid UUID generation mode specification");
     }
+    $mode = [ @{$mode} ];
     if ($mode->[0] =~ m|^v[35]$|) {
         my $uuid_ns = new OSSP::uuid;
         $uuid_ns->load($mode->[1])
             or return (undef, "failed to load UUID $mode->[0] namespace");
         $mode->[1] = $uuid_ns;
     }
+    #   resolve the mode code once, so FETCH is a single XS call
+    $mode->[0] = OSSP::uuid::mode_code($mode->[0]);
     return ($mode, undef);
 }
 
@@ -86,10 +89,11 @@ sub DESTROY {
 #   (applied semantic: export UUID in string format)
 sub FETCH {
     my ($self) = @_;
-    $self->{-uuid}->make(@{$self->{-mode}})
+    my ($mode, $ns, $name) = @{$self->{-mode}};
+    my $value = (defined($ns)
+        ? OSSP::uuid::uuid_generate($self->{-uuid}->{-uuid}, $mode, OSSP::uuid::UUID_FMT_STR(), $ns->{-uuid}, $name)
+        : OSSP::uuid::uuid_generate($self->{-uuid}->{-uuid}, $mode, OSSP::uuid::UUID_FMT_STR()))
        or croak "failed to generate new UUID";
-    my $value = $self->{-uuid}->export("str")
-       or croak "failed to export new UUID";
     return $value;
 }
 
@@ -130,6 +134,10 @@ my $symbols = {
         UUID_LEN_BIN
         UUID_LEN_STR
         UUID_LEN_SIV
+        UUID_LEN_B64
+        UUID_LEN_B32
+        UUID_LEN_B58
+        UUID_LEN_ULID
         UUID_RC_OK
         UUID_RC_ARG
         UUID_RC_MEM
@@ -141,10 +149,16 @@ my $symbols = {
         UUID_MAKE_V4
         UUID_MAKE_V5
         UUID_MAKE_MC
+        UUID_MAKE_V7
+        UUID_MAKE_ULID
         UUID_FMT_BIN
         UUID_FMT_STR
         UUID_FMT_SIV
         UUID_FMT_TXT
+        UUID_FMT_B64
+        UUID_FMT_B32
+        UUID_FMT_B58
+        UUID_FMT_ULID
     )],
     'func' => [qw(
         uuid_create
@@ -155,6 +169,8 @@ my $symbols = {
         uuid_compare
         uuid_import
         uuid_export
+        uuid_generate
+        uuid_generate_list
         uuid_error
         uuid_version
     )]
@@ -204,17 +220,40 @@ sub load ($$) {
     return ($self->{-rc} == $self->UUID_RC_OK);
 }
 
-sub make ($$;@) {
-    my ($self, $mode, @valist) = @_;
+#   helper function: mode specification to mode code
+sub mode_code ($) {
+    my ($mode) = @_;
     my $mode_code = 0;
     foreach my $spec (split(/,/, $mode)) {
-        if    ($spec eq 'v1') { $mode_code |= $self->UUID_MAKE_V1; }
-        elsif ($spec eq 'v3') { $mode_code |= $self->UUID_MAKE_V3; }
-        elsif ($spec eq 'v4') { $mode_code |= $self->UUID_MAKE_V4; }
-        elsif ($spec eq 'v5') { $mode_code |= $self->UUID_MAKE_V5; }
-        elsif ($spec eq 'mc') { $mode_code |= $self->UUID_MAKE_MC; }
+        if    ($spec eq 'v1') { $mode_code |= UUID_MAKE_V1(); }
+        elsif ($spec eq 'v3') { $mode_code |= UUID_MAKE_V3(); }
+        elsif ($spec eq 'v4') { $mode_code |= UUID_MAKE_V4(); }
+        elsif ($spec eq 'v5') { $mode_code |= UUID_MAKE_V5(); }
+        elsif ($spec eq 'v7') { $mode_code |= UUID_MAKE_V7(); }
+        elsif ($spec eq 'ulid') { $mode_code |= UUID_MAKE_ULID(); }
+        elsif ($spec eq 'mc') { $mode_code |= UUID_MAKE_MC(); }
         else  { croak("invalid mode specification \"$spec\""); }
     }
+    return $mode_code;
+}
+
+#   helper function: format specification to format code
+sub fmt_code ($) {
+    my ($fmt) = @_;
+    if    ($fmt eq 'bin') { return UUID_FMT_BIN(); }
+    elsif ($fmt eq 'str') { return UUID_FMT_STR(); }
+    elsif ($fmt eq 'siv') { return UUID_FMT_SIV(); }
+    elsif ($fmt eq 'txt') { return UUID_FMT_TXT(); }
+    elsif ($fmt eq 'b64') { return UUID_FMT_B64(); }
+    elsif ($fmt eq 'b32') { return UUID_FMT_B32(); }
+    elsif ($fmt eq 'b58') { return UUID_FMT_B58(); }
+    elsif ($fmt eq 'ulid') { return UUID_FMT_ULID(); }
+    else  { croak("invalid format \"$fmt\""); }
+}
+
+sub make ($$;@) {
+    my ($self, $mode, @valist) = @_;
+    my $mode_code = mode_code($mode);
     if (($mode_code & $self->UUID_MAKE_V3) or ($mode_code & $self->UUID_MAKE_V5)) {
         if (not (ref($valist[0]) and $valist[0]->isa("OSSP::uuid"))) {
             croak("UUID_MAKE_V3/UUID_MAKE_V5 requires namespace argument to be OSSP::uuid object");
@@ -260,6 +299,10 @@ sub import {
         elsif ($fmt eq 'str') { $fmt = $self->UUID_FMT_STR; }
         elsif ($fmt eq 'siv') { $fmt = $self->UUID_FMT_SIV; }
         elsif ($fmt eq 'txt') { $fmt = $self->UUID_FMT_TXT; }
+        elsif ($fmt eq 'b64') { $fmt = $self->UUID_FMT_B64; }
+        elsif ($fmt eq 'b32') { $fmt = $self->UUID_FMT_B32; }
+        elsif ($fmt eq 'b58') { $fmt = $self->UUID_FMT_B58; }
+        elsif ($fmt eq 'ulid') { $fmt = $self->UUID_FMT_ULID; }
         else  { croak("invalid format \"$fmt\""); }
         $data_len ||= length($data_ptr); # functional redudant, but Perl dislikes undef value here
         $self->{-rc} = uuid_import($self->{-uuid}, $fmt, $data_ptr, $data_len);
@@ -288,6 +331,10 @@ sub export {
         elsif ($fmt eq 'str') { $fmt = $self->UUID_FMT_STR; }
         elsif ($fmt eq 'siv') { $fmt = $self->UUID_FMT_SIV; }
         elsif ($fmt eq 'txt') { $fmt = $self->UUID_FMT_TXT; }
+        elsif ($fmt eq 'b64') { $fmt = $self->UUID_FMT_B64; }
+        elsif ($fmt eq 'b32') { $fmt = $self->UUID_FMT_B32; }
+        elsif ($fmt eq 'b58') { $fmt = $self->UUID_FMT_B58; }
+        elsif ($fmt eq 'ulid') { $fmt = $self->UUID_FMT_ULID; }
         else  { croak("invalid format \"$fmt\""); }
         $self->{-rc} = uuid_export($self->{-uuid}, $fmt, $data_ptr, undef);
         return ($self->{-rc} == $self->UUID_RC_OK ? $data_ptr : undef);
@@ -299,6 +346,23 @@ sub export {
     }
 }
 
+sub generate ($$$;@) {
+    my ($self, $mode, $fmt, @valist) = @_;
+    my $mode_code = mode_code($mode);
+    if (($mode_code & $self->UUID_MAKE_V3) or ($mode_code & $self->UUID_MAKE_V5)) {
+        if (not (ref($valist[0]) and $valist[0]->isa("OSSP::uuid"))) {
+            croak("UUID_MAKE_V3/UUID_MAKE_V5 requires namespace argument to be OSSP::uuid object");
+        }
+        return uuid_generate($self->{-uuid}, $mode_code, fmt_code($fmt), $valist[0]->{-uuid}, $valist[1]);
+    }
+    return uuid_generate($self->{-uuid}, $mode_code, fmt_code($fmt));
+}
+
+sub generate_list ($$$$) {
+    my ($self, $mode, $fmt, $n) = @_;
+    return uuid_generate_list($self->{-uuid}, mode_code($mode), fmt_code($fmt), $n);
+}
+
 sub error ($;$) {
     my ($self, $rc) = @_;
     $rc = $self->{-rc} if (not defined($rc));
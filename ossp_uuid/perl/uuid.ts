@@ -27,7 +27,7 @@
 ##  uuid.ts: Perl Binding (Perl test suite part)
 ##
 
-use Test::More tests => 36;
+use Test::More tests => 45;
 
 ##
 ##  Module Loading
@@ -91,6 +91,16 @@ $rc = uuid_export($uuid_ns, UUID_FMT_SIV, $ptr, $len);
 ok((    $rc == UUID_RC_OK
     and $ptr eq "3789866285607910888100818383505376205"
     and $len <= UUID_LEN_SIV), "uuid_export (6)");
+$rc = uuid_export($uuid_ns, UUID_FMT_B32, $ptr, $len);
+ok((    $rc == UUID_RC_OK
+    and $ptr eq "02V7KDB53770Q8Z6WK02K4NGYD"
+    and $len == UUID_LEN_B32), "uuid_export (7)");
+$rc = uuid_import($uuid, UUID_FMT_B64, "Atnm1ZRnOC6Pm5MApkrDzQ", UUID_LEN_B64);
+ok($rc == UUID_RC_OK, "uuid_import (2)");
+$rc = uuid_export($uuid, UUID_FMT_B58, $ptr, $len);
+ok((    $rc == UUID_RC_OK
+    and $ptr eq "1MRPBzCvYDasUhBd5eB1LY"
+    and $len == UUID_LEN_B58), "uuid_export (8)");
 
 $rc = uuid_destroy($uuid_ns);
 ok($rc == UUID_RC_OK, "uuid_destroy (1)");
@@ -143,6 +153,27 @@ ok((    defined($ptr)
     and $ptr eq "02d9e6d5-9467-382e-8f9b-9300a64ac3cd"
     and length($ptr) == UUID_LEN_STR), "export (5)");
 
+$rc = $uuid_ns->load("ns:URL");
+$ptr = $uuid->generate("v3", "str", $uuid_ns, "http://www.ossp.org/");
+ok((    defined($ptr)
+    and $ptr eq "02d9e6d5-9467-382e-8f9b-9300a64ac3cd"), "generate (1)");
+$ptr = $uuid->generate("v4", "bin");
+ok((    defined($ptr)
+    and length($ptr) == UUID_LEN_BIN), "generate (2)");
+my @list = $uuid->generate_list("v7", "str", 100);
+ok((    @list == 100
+    and join(",", sort @list) eq join(",", @list)), "generate_list (1)");
+my %seen = map { $_ => 1 } @list;
+ok(keys(%seen) == 100, "generate_list (2)");
+@list = $uuid->generate_list("ulid", "ulid", 100);
+ok((    @list == 100
+    and length($list[0]) == UUID_LEN_ULID
+    and join(",", sort @list) eq join(",", @list)), "generate_list (3)");
+$rc = $uuid->import("ulid", "01ARZ3NDEKTSV4RRFFQ69G5FAV");
+$ptr = $uuid->export("str");
+ok((    defined($rc)
+    and $ptr eq "01563e3a-b5d3-d676-4c61-efb99302bd5b"), "import (2)");
+
 undef $uuid;
 undef $uuid_ns;
 
@@ -33,6 +33,29 @@
 #include "perl.h"
 #include "XSUB.h"
 
+/* INTERNAL: export UUID into a new SV
+   (all formats except UUID_FMT_TXT without any heap allocation besides the SV) */
+static uuid_rc_t export_sv(pTHX_ uuid_t *uuid, uuid_fmt_t fmt, SV **sv)
+{
+    char buf[UUID_LEN_SIV+1];
+    void *data_ptr;
+    size_t data_len;
+    uuid_rc_t rc;
+
+    data_ptr = (fmt == UUID_FMT_TXT ? NULL : buf);
+    data_len = sizeof(buf);
+    if ((rc = uuid_export(uuid, fmt, &data_ptr, &data_len)) != UUID_RC_OK)
+        return rc;
+    if (fmt == UUID_FMT_SIV)
+        data_len = strlen((char *)data_ptr);
+    else if (fmt != UUID_FMT_BIN)
+        data_len--; /* Perl doesn't wish NUL-termination on strings */
+    *sv = newSVpvn((char *)data_ptr, data_len);
+    if (data_ptr != buf)
+        free(data_ptr);
+    return UUID_RC_OK;
+}
+
 MODULE = OSSP::uuid PACKAGE = OSSP::uuid
 
 void
@@ -49,6 +72,10 @@ constant(sv)
             { "UUID_LEN_BIN", UUID_LEN_BIN },
             { "UUID_LEN_STR", UUID_LEN_STR },
             { "UUID_LEN_SIV", UUID_LEN_SIV },
+            { "UUID_LEN_B64", UUID_LEN_B64 },
+            { "UUID_LEN_B32", UUID_LEN_B32 },
+            { "UUID_LEN_B58", UUID_LEN_B58 },
+            { "UUID_LEN_ULID", UUID_LEN_ULID },
             { "UUID_RC_OK",   UUID_RC_OK   },
             { "UUID_RC_ARG",  UUID_RC_ARG  },
             { "UUID_RC_MEM",  UUID_RC_MEM  },
@@ -60,10 +87,16 @@ constant(sv)
             { "UUID_MAKE_V4", UUID_MAKE_V4 },
             { "UUID_MAKE_V5", UUID_MAKE_V5 },
             { "UUID_MAKE_MC", UUID_MAKE_MC },
+            { "UUID_MAKE_V7", UUID_MAKE_V7 },
+            { "UUID_MAKE_ULID", UUID_MAKE_ULID },
             { "UUID_FMT_BIN", UUID_FMT_BIN },
             { "UUID_FMT_STR", UUID_FMT_STR },
             { "UUID_FMT_SIV", UUID_FMT_SIV },
-            { "UUID_FMT_TXT", UUID_FMT_TXT }
+            { "UUID_FMT_TXT", UUID_FMT_TXT },
+            { "UUID_FMT_B64", UUID_FMT_B64 },
+            { "UUID_FMT_B32", UUID_FMT_B32 },
+            { "UUID_FMT_B58", UUID_FMT_B58 },
+            { "UUID_FMT_ULID", UUID_FMT_ULID }
         };
     INPUT:
         SV             *sv;
@@ -205,7 +238,7 @@ uuid_export(uuid,fmt,data_ptr,data_len)
         if (RETVAL == UUID_RC_OK) {
             if (fmt == UUID_FMT_SIV)
                 data_len = strlen((char *)data_ptr);
-            else if (fmt == UUID_FMT_STR || fmt == UUID_FMT_TXT)
+            else if (fmt != UUID_FMT_BIN)
                 data_len--; /* Perl doesn't wish NUL-termination on strings */
             sv_setpvn(ST(2), data_ptr, data_len);
             free(data_ptr);
@@ -214,6 +247,66 @@ uuid_export(uuid,fmt,data_ptr,data_len)
         }
         PUSHi((IV)RETVAL);
 
+void
+uuid_generate(uuid,mode,fmt,...)
+    PROTOTYPE:
+        $$$;$$
+    INPUT:
+        uuid_t *uuid
+        unsigned int mode
+        uuid_fmt_t fmt
+    PREINIT:
+        uuid_t *ns;
+        const char *name;
+        uuid_rc_t rc;
+        SV *sv;
+    PPCODE:
+        if ((mode & UUID_MAKE_V3) || (mode & UUID_MAKE_V5)) {
+            if (items != 5)
+                croak("mode UUID_MAKE_V3/UUID_MAKE_V5 requires two additional arguments to uuid_generate()");
+            if (!SvROK(ST(3)))
+                croak("mode UUID_MAKE_V3/UUID_MAKE_V5 requires a UUID object as namespace");
+            ns   = INT2PTR(uuid_t *, SvIV((SV*)SvRV(ST(3))));
+            name = (const char *)SvPV_nolen(ST(4));
+            rc = uuid_make(uuid, mode, ns, name);
+        }
+        else {
+            if (items != 3)
+                croak("invalid number of arguments to uuid_generate()");
+            rc = uuid_make(uuid, mode);
+        }
+        if (rc == UUID_RC_OK)
+            rc = export_sv(aTHX_ uuid, fmt, &sv);
+        if (rc == UUID_RC_OK)
+            XPUSHs(sv_2mortal(sv));
+        else
+            XPUSHs(&PL_sv_undef);
+
+void
+uuid_generate_list(uuid,mode,fmt,n)
+    PROTOTYPE:
+        $$$$
+    INPUT:
+        uuid_t *uuid
+        unsigned int mode
+        uuid_fmt_t fmt
+        IV n
+    PREINIT:
+        IV i;
+        SV *sv;
+    PPCODE:
+        if ((mode & UUID_MAKE_V3) || (mode & UUID_MAKE_V5))
+            croak("mode UUID_MAKE_V3/UUID_MAKE_V5 not supported by uuid_generate_list()");
+        if (n < 0)
+            croak("invalid number of UUIDs for uuid_generate_list()");
+        EXTEND(SP, n);
+        for (i = 0; i < n; i++) {
+            if (   uuid_make(uuid, mode) != UUID_RC_OK
+                || export_sv(aTHX_ uuid, fmt, &sv) != UUID_RC_OK)
+                XSRETURN_EMPTY;
+            PUSHs(sv_2mortal(sv));
+        }
+
 char *
 uuid_error(rc)
     PROTOTYPE:
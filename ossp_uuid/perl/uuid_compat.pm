@@ -44,19 +44,25 @@ our @EXPORT  = qw(NameSpace_DNS NameSpace_OID NameSpace_URL NameSpace_X500);
 
 our $VERSION = do { my @v = ('1.6.2' =~ m/\d+/g); sprintf("%d.".("%02d"x$#v), @v); };
 
+#   constants resolved once for the generation fast paths
+my $MAKE_V4 = OSSP::uuid::UUID_MAKE_V4();
+my $FMT_BIN = OSSP::uuid::UUID_FMT_BIN();
+my $FMT_STR = OSSP::uuid::UUID_FMT_STR();
+
 sub new {
     my $class = shift;
     my $self = bless {}, $class;
+    $self->{-uuid} = OSSP::uuid->new;
     return $self;
 }
 
 sub create {
     my ($self) = @_;
-    my $uuid = OSSP::uuid->new;
-    $uuid->make('v4');
-    return $uuid->export('bin');
+    return OSSP::uuid::uuid_generate($self->{-uuid}->{-uuid}, $MAKE_V4, $FMT_BIN);
 }
 
+*create_bin = \&create;
+
 sub create_from_name {
     my ($self, $nsid, $name) = @_;
     my $uuid = OSSP::uuid->new;
@@ -143,8 +149,8 @@ sub constant {
 }
 
 sub create_str {
-    my $self = shift;
-    return $self->to_string($self->create);
+    my ($self) = @_;
+    return OSSP::uuid::uuid_generate($self->{-uuid}->{-uuid}, $MAKE_V4, $FMT_STR);
 }
 
 sub create_hex {
@@ -32,14 +32,28 @@
 
 /*  PostgreSQL (part 1/2) headers */
 #include "postgres.h"
+#if PG_VERSION_NUM < 110000
+#error "OSSP uuid PostgreSQL binding requires PostgreSQL >= 11"
+#endif
 
 /*  system headers */
 #include <string.h>
+#include <unistd.h>
 
 /*  PostgreSQL (part 2/2) headers */
 #include "fmgr.h"
+#include "funcapi.h"
 #include "lib/stringinfo.h"
 #include "access/hash.h"
+#include "utils/sortsupport.h"
+#include "lib/hyperloglog.h"
+#include "utils/memutils.h"
+#include "access/brin_internal.h"
+#include "access/brin_tuple.h"
+#include "access/skey.h"
+#include "catalog/pg_type.h"
+#include "utils/typcache.h"
+#include "utils/timestamp.h"
 
 /*  PostgreSQL module magic cookie
     (PostgreSQL >= 8.2 only) */
@@ -58,7 +72,9 @@ Datum pg_uuid_out    (PG_FUNCTION_ARGS);
 Datum pg_uuid_recv   (PG_FUNCTION_ARGS);
 Datum pg_uuid_send   (PG_FUNCTION_ARGS);
 Datum pg_uuid_hash   (PG_FUNCTION_ARGS);
+Datum pg_uuid_hash_extended(PG_FUNCTION_ARGS);
 Datum pg_uuid_make   (PG_FUNCTION_ARGS);
+Datum pg_uuid_generate_series(PG_FUNCTION_ARGS);
 Datum pg_uuid_eq     (PG_FUNCTION_ARGS);
 Datum pg_uuid_ne     (PG_FUNCTION_ARGS);
 Datum pg_uuid_lt     (PG_FUNCTION_ARGS);
@@ -66,6 +82,78 @@ Datum pg_uuid_gt     (PG_FUNCTION_ARGS);
 Datum pg_uuid_le     (PG_FUNCTION_ARGS);
 Datum pg_uuid_ge     (PG_FUNCTION_ARGS);
 Datum pg_uuid_cmp    (PG_FUNCTION_ARGS);
+Datum pg_uuid_sortsupport(PG_FUNCTION_ARGS);
+Datum pg_uuid_timestamp(PG_FUNCTION_ARGS);
+Datum pg_uuid_time_min(PG_FUNCTION_ARGS);
+Datum pg_uuid_time_max(PG_FUNCTION_ARGS);
+Datum pg_uuid_time_lt(PG_FUNCTION_ARGS);
+Datum pg_uuid_time_le(PG_FUNCTION_ARGS);
+Datum pg_uuid_time_eq(PG_FUNCTION_ARGS);
+Datum pg_uuid_time_ge(PG_FUNCTION_ARGS);
+Datum pg_uuid_time_gt(PG_FUNCTION_ARGS);
+Datum pg_uuid_brin_time_opcinfo(PG_FUNCTION_ARGS);
+Datum pg_uuid_brin_time_add_value(PG_FUNCTION_ARGS);
+Datum pg_uuid_brin_time_consistent(PG_FUNCTION_ARGS);
+Datum pg_uuid_brin_time_union(PG_FUNCTION_ARGS);
+
+/* INTERNAL function: value of hexadecimal digit (or -1) */
+static int _uuid_hexval(int c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    c |= 0x20; /* lower case */
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+/* INTERNAL function: parse UUID string representation into binary
+   representation (accepts upper and lower case, the forms with and
+   without hyphens, enclosed in braces and prefixed with "urn:uuid:") */
+static int _uuid_parse(const char *str, unsigned char *bin)
+{
+    const char *cp;
+    int braces;
+    int hyphens;
+    int hi, lo;
+    int i;
+
+    /* optional URN prefix and braces */
+    cp = str;
+    if (   (cp[0] == 'u' || cp[0] == 'U')
+        && (cp[1] == 'r' || cp[1] == 'R')
+        && (cp[2] == 'n' || cp[2] == 'N')
+        && cp[3] == ':'
+        && (cp[4] == 'u' || cp[4] == 'U')
+        && (cp[5] == 'u' || cp[5] == 'U')
+        && (cp[6] == 'i' || cp[6] == 'I')
+        && (cp[7] == 'd' || cp[7] == 'D')
+        && cp[8] == ':')
+        cp += 9;
+    braces = (*cp == '{');
+    if (braces)
+        cp++;
+
+    /* either all four or none of the hyphens */
+    hyphens = (strlen(cp) >= 9 && cp[8] == '-');
+
+    /* 16 octets of two hexadecimal digits each */
+    for (i = 0; i < UUID_LEN_BIN; i++) {
+        if (hyphens && (i == 4 || i == 6 || i == 8 || i == 10)) {
+            if (*cp++ != '-')
+                return 0;
+        }
+        if ((hi = _uuid_hexval((unsigned char)cp[0])) < 0)
+            return 0;
+        if ((lo = _uuid_hexval((unsigned char)cp[1])) < 0)
+            return 0;
+        bin[i] = (unsigned char)((hi << 4) | lo);
+        cp += 2;
+    }
+    if (braces && *cp++ != '}')
+        return 0;
+    return (*cp == '\0');
+}
 
 /* API function: uuid_in */
 PG_FUNCTION_INFO_V1(pg_uuid_in);
@@ -73,43 +161,19 @@ Datum pg_uuid_in(PG_FUNCTION_ARGS)
 {
     char *uuid_str;
     uuid_datum_t *uuid_datum;
-    uuid_rc_t rc;
-    uuid_t *uuid;
-    void *vp;
-    size_t len;
 
     /* sanity check input argument */
     if ((uuid_str = PG_GETARG_CSTRING(0)) == NULL)
         ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
                 errmsg("invalid UUID string")));
-    if ((len = strlen(uuid_str)) != UUID_LEN_STR)
-        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("invalid UUID string length %d (expected %d)", (int)len, UUID_LEN_STR)));
 
-    /* import as string representation */
-    if ((rc = uuid_create(&uuid)) != UUID_RC_OK)
-        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("failed to create UUID object: %s", uuid_error(rc))));
-    if ((rc = uuid_import(uuid, UUID_FMT_STR, uuid_str, len)) != UUID_RC_OK) {
-        uuid_destroy(uuid);
-        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("failed to import UUID string representation: %s", uuid_error(rc))));
-    }
-
-    /* export as binary representation */
-    if ((uuid_datum = (uuid_datum_t *)palloc(sizeof(uuid_datum_t))) == NULL) {
-        uuid_destroy(uuid);
+    /* parse string representation directly into the datum */
+    if ((uuid_datum = (uuid_datum_t *)palloc(sizeof(uuid_datum_t))) == NULL)
         ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
                 errmsg("failed to allocate UUID datum")));
-    }
-    vp = &(uuid_datum->uuid_bin);
-    len = sizeof(uuid_datum->uuid_bin);
-    if ((rc = uuid_export(uuid, UUID_FMT_BIN, &vp, &len)) != UUID_RC_OK) {
-        uuid_destroy(uuid);
+    if (!_uuid_parse(uuid_str, uuid_datum->uuid_bin))
         ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("failed to export UUID binary representation: %s", uuid_error(rc))));
-    }
-    uuid_destroy(uuid);
+                errmsg("invalid UUID string representation \"%s\"", uuid_str)));
 
     /* return UUID datum */
     PG_RETURN_POINTER(uuid_datum);
@@ -119,41 +183,29 @@ Datum pg_uuid_in(PG_FUNCTION_ARGS)
 PG_FUNCTION_INFO_V1(pg_uuid_out);
 Datum pg_uuid_out(PG_FUNCTION_ARGS)
 {
+    static const char hex[] = "0123456789abcdef";
     uuid_datum_t *uuid_datum;
-    uuid_rc_t rc;
-    uuid_t *uuid;
     char *uuid_str;
-    void *vp;
-    size_t len;
+    char *cp;
+    int i;
 
     /* sanity check input argument */
     if ((uuid_datum = (uuid_datum_t *)PG_GETARG_POINTER(0)) == NULL)
         ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
                 errmsg("invalid UUID datum")));
 
-    /* import as binary representation */
-    if ((rc = uuid_create(&uuid)) != UUID_RC_OK)
-        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("failed to create UUID object: %s", uuid_error(rc))));
-    if ((rc = uuid_import(uuid, UUID_FMT_BIN, uuid_datum->uuid_bin, sizeof(uuid_datum->uuid_bin))) != UUID_RC_OK) {
-        uuid_destroy(uuid);
-        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("failed to import UUID binary representation: %s", uuid_error(rc))));
-    }
-
-    /* export as string representation */
-    len = UUID_LEN_STR+1;
-    if ((vp = uuid_str = (char *)palloc(len)) == NULL) {
-        uuid_destroy(uuid);
+    /* format string representation directly from the datum */
+    if ((uuid_str = (char *)palloc(UUID_LEN_STR+1)) == NULL)
         ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
                 errmsg("failed to allocate UUID string")));
+    cp = uuid_str;
+    for (i = 0; i < UUID_LEN_BIN; i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10)
+            *cp++ = '-';
+        *cp++ = hex[(uuid_datum->uuid_bin[i] >> 4) & 0x0f];
+        *cp++ = hex[ uuid_datum->uuid_bin[i]       & 0x0f];
     }
-    if ((rc = uuid_export(uuid, UUID_FMT_STR, &vp, &len)) != UUID_RC_OK) {
-        uuid_destroy(uuid);
-        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("failed to export UUID string representation: %s", uuid_error(rc))));
-    }
-    uuid_destroy(uuid);
+    *cp = '\0';
 
     /* return UUID string */
     PG_RETURN_CSTRING(uuid_str);
@@ -211,86 +263,169 @@ Datum pg_uuid_send(PG_FUNCTION_ARGS)
     PG_RETURN_BYTEA_P(uuid_bytea);
 }
 
-/* API function: uuid_make */
-PG_FUNCTION_INFO_V1(pg_uuid_make);
-Datum pg_uuid_make(PG_FUNCTION_ARGS)
+/* per-backend UUID generator objects
+   (created on first use and kept for the lifetime of the backend, so the
+   PRNG, MAC address and the version 1/7 time state survive across calls) */
+static uuid_t *uuid_gen    = NULL;
+static uuid_t *uuid_gen_ns = NULL;
+static pid_t   uuid_gen_pid = 0;
+
+/* INTERNAL function: determine per-backend UUID generator objects */
+static uuid_t *_uuid_generator(uuid_t **uuid_ns)
 {
-    uuid_t *uuid;
-    uuid_t *uuid_ns;
     uuid_rc_t rc;
-    int version;
+
+    /* never share state with the parent process (preloaded library) */
+    if (uuid_gen != NULL && uuid_gen_pid != getpid()) {
+        uuid_destroy(uuid_gen);
+        uuid_gen = NULL;
+        if (uuid_gen_ns != NULL) {
+            uuid_destroy(uuid_gen_ns);
+            uuid_gen_ns = NULL;
+        }
+    }
+    if (uuid_gen == NULL) {
+        if ((rc = uuid_create(&uuid_gen)) != UUID_RC_OK) {
+            uuid_gen = NULL;
+            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                    errmsg("failed to create UUID object: %s", uuid_error(rc))));
+        }
+        uuid_gen_pid = getpid();
+    }
+    if (uuid_ns != NULL) {
+        if (uuid_gen_ns == NULL) {
+            if ((rc = uuid_create(&uuid_gen_ns)) != UUID_RC_OK) {
+                uuid_gen_ns = NULL;
+                ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                        errmsg("failed to create UUID namespace object: %s", uuid_error(rc))));
+            }
+        }
+        *uuid_ns = uuid_gen_ns;
+    }
+    return uuid_gen;
+}
+
+/* INTERNAL function: map UUID version onto make mode */
+static unsigned int _uuid_mode(int version)
+{
     unsigned int mode = 0;
-    uuid_datum_t *uuid_datum;
-    char *str_ns;
-    char *str_name;
-    void *vp;
-    size_t len;
 
-    /* sanity check input argument */
-    version = (int)PG_GETARG_INT32(0);
     switch (version) {
         case 1: mode = UUID_MAKE_V1; break;
         case 3: mode = UUID_MAKE_V3; break;
         case 4: mode = UUID_MAKE_V4; break;
         case 5: mode = UUID_MAKE_V5; break;
+        case 7: mode = UUID_MAKE_V7; break;
         default:
             ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                    errmsg("invalid UUID version %d (expected 1, 3, 4 or 5)", version)));
+                    errmsg("invalid UUID version %d (expected 1, 3, 4, 5 or 7)", version)));
     }
-    if (   ((mode & (UUID_MAKE_V1|UUID_MAKE_V4)) && PG_NARGS() != 1)
-        || ((mode & (UUID_MAKE_V3|UUID_MAKE_V5)) && PG_NARGS() != 3))
-        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("invalid number (%d) of arguments", PG_NARGS())));
+    return mode;
+}
+
+/* INTERNAL function: make a new UUID datum */
+static uuid_datum_t *_uuid_make(int version, unsigned int mode, const char *str_ns, const char *str_name)
+{
+    uuid_t *uuid;
+    uuid_t *uuid_ns;
+    uuid_rc_t rc;
+    uuid_datum_t *uuid_datum;
+    void *vp;
+    size_t len;
 
     /* make a new UUID */
-    if ((rc = uuid_create(&uuid)) != UUID_RC_OK)
-        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("failed to create UUID object: %s", uuid_error(rc))));
-    if (version == 3 || version == 5) {
-        if ((str_ns = PG_GETARG_CSTRING(1)) == NULL)
-            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                    errmsg("invalid namespace UUID string")));
-        if ((str_name = PG_GETARG_CSTRING(2)) == NULL)
-            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                    errmsg("invalid name string")));
-        if ((rc = uuid_create(&uuid_ns)) != UUID_RC_OK)
-            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                    errmsg("failed to create UUID namespace object: %s", uuid_error(rc))));
+    if (mode & (UUID_MAKE_V3|UUID_MAKE_V5)) {
+        uuid = _uuid_generator(&uuid_ns);
         if ((rc = uuid_load(uuid_ns, str_ns)) != UUID_RC_OK) {
             if ((rc = uuid_import(uuid_ns, UUID_FMT_STR, str_ns, strlen(str_ns))) != UUID_RC_OK)
                 ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
                         errmsg("failed to import UUID namespace: %s", uuid_error(rc))));
         }
-        if ((rc = uuid_make(uuid, mode, uuid_ns, str_name)) != UUID_RC_OK) {
-            uuid_destroy(uuid);
+        if ((rc = uuid_make(uuid, mode, uuid_ns, str_name)) != UUID_RC_OK)
             ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
                     errmsg("failed to make v%d UUID: %s", version, uuid_error(rc))));
-        }
-        uuid_destroy(uuid_ns);
     }
     else {
-        if ((rc = uuid_make(uuid, mode)) != UUID_RC_OK) {
-            uuid_destroy(uuid);
+        uuid = _uuid_generator(NULL);
+        if ((rc = uuid_make(uuid, mode)) != UUID_RC_OK)
             ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
                     errmsg("failed to make v%d UUID: %s", version, uuid_error(rc))));
-        }
     }
 
     /* export as binary representation */
-    if ((uuid_datum = (uuid_datum_t *)palloc(sizeof(uuid_datum_t))) == NULL) {
-        uuid_destroy(uuid);
+    if ((uuid_datum = (uuid_datum_t *)palloc(sizeof(uuid_datum_t))) == NULL)
         ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
                 errmsg("failed to allocate UUID datum")));
-    }
     vp = &(uuid_datum->uuid_bin);
     len = sizeof(uuid_datum->uuid_bin);
-    if ((rc = uuid_export(uuid, UUID_FMT_BIN, &vp, &len)) != UUID_RC_OK) {
-        uuid_destroy(uuid);
+    if ((rc = uuid_export(uuid, UUID_FMT_BIN, &vp, &len)) != UUID_RC_OK)
         ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
                 errmsg("failed to export UUID binary representation: %s", uuid_error(rc))));
+    return uuid_datum;
+}
+
+/* API function: uuid_make */
+PG_FUNCTION_INFO_V1(pg_uuid_make);
+Datum pg_uuid_make(PG_FUNCTION_ARGS)
+{
+    int version;
+    unsigned int mode;
+    char *str_ns = NULL;
+    char *str_name = NULL;
+
+    /* sanity check input argument */
+    version = (int)PG_GETARG_INT32(0);
+    mode = _uuid_mode(version);
+    if (   ((mode & (UUID_MAKE_V1|UUID_MAKE_V4|UUID_MAKE_V7)) && PG_NARGS() != 1)
+        || ((mode & (UUID_MAKE_V3|UUID_MAKE_V5)) && PG_NARGS() != 3))
+        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                errmsg("invalid number (%d) of arguments", PG_NARGS())));
+    if (mode & (UUID_MAKE_V3|UUID_MAKE_V5)) {
+        if ((str_ns = PG_GETARG_CSTRING(1)) == NULL)
+            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                    errmsg("invalid namespace UUID string")));
+        if ((str_name = PG_GETARG_CSTRING(2)) == NULL)
+            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                    errmsg("invalid name string")));
     }
-    uuid_destroy(uuid);
-    PG_RETURN_POINTER(uuid_datum);
+
+    /* make a new UUID */
+    PG_RETURN_POINTER(_uuid_make(version, mode, str_ns, str_name));
+}
+
+/* API function: uuid_generate_series */
+PG_FUNCTION_INFO_V1(pg_uuid_generate_series);
+Datum pg_uuid_generate_series(PG_FUNCTION_ARGS)
+{
+    FuncCallContext *funcctx;
+    int version;
+    unsigned int mode;
+    int64 count;
+
+    /* sanity check input arguments (on first call only) */
+    if (SRF_IS_FIRSTCALL()) {
+        version = (int)PG_GETARG_INT32(0);
+        mode = _uuid_mode(version);
+        if (mode & (UUID_MAKE_V3|UUID_MAKE_V5))
+            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                    errmsg("invalid UUID version %d (expected 1, 4 or 7)", version)));
+        if ((count = PG_GETARG_INT64(1)) < 0)
+            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                    errmsg("invalid UUID count " INT64_FORMAT, count)));
+        (void)_uuid_generator(NULL);
+        funcctx = SRF_FIRSTCALL_INIT();
+        funcctx->max_calls = (uint64)count;
+        funcctx->user_fctx = (void *)(uintptr_t)mode;
+    }
+
+    /* make the next UUID out of the per-backend generator */
+    funcctx = SRF_PERCALL_SETUP();
+    if (funcctx->call_cntr < funcctx->max_calls) {
+        mode = (unsigned int)(uintptr_t)funcctx->user_fctx;
+        version = (int)PG_GETARG_INT32(0);
+        SRF_RETURN_NEXT(funcctx, PointerGetDatum(_uuid_make(version, mode, NULL, NULL)));
+    }
+    SRF_RETURN_DONE(funcctx);
 }
 
 /* API function: uuid_hash */
@@ -308,14 +443,28 @@ Datum pg_uuid_hash(PG_FUNCTION_ARGS)
     PG_RETURN_INT32(hash_any(uuid_datum->uuid_bin, sizeof(uuid_datum->uuid_bin)));
 }
 
+/* API function: uuid_hash_extended
+   (seeded 64-bit hash for hash partitioning) */
+PG_FUNCTION_INFO_V1(pg_uuid_hash_extended);
+Datum pg_uuid_hash_extended(PG_FUNCTION_ARGS)
+{
+    uuid_datum_t *uuid_datum;
+
+    /* sanity check input argument */
+    if ((uuid_datum = (uuid_datum_t *)PG_GETARG_POINTER(0)) == NULL)
+        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                errmsg("invalid UUID datum argument")));
+
+    /* return seeded 64-bit hash value of the UUID */
+    PG_RETURN_DATUM(hash_any_extended(uuid_datum->uuid_bin, sizeof(uuid_datum->uuid_bin),
+                                      (uint64)PG_GETARG_INT64(1)));
+}
+
 /* INTERNAL function: _uuid_cmp */
 static int _uuid_cmp(PG_FUNCTION_ARGS)
 {
     uuid_datum_t *uuid_datum1;
     uuid_datum_t *uuid_datum2;
-    uuid_t *uuid1;
-    uuid_t *uuid2;
-    uuid_rc_t rc;
     int result;
 
     /* sanity check input argument */
@@ -326,42 +475,13 @@ static int _uuid_cmp(PG_FUNCTION_ARGS)
         ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
                 errmsg("invalid second UUID datum argument")));
 
-    /* load both UUIDs */
-    if ((rc = uuid_create(&uuid1)) != UUID_RC_OK)
-        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("failed to create UUID object: %s", uuid_error(rc))));
-    if ((rc = uuid_create(&uuid2)) != UUID_RC_OK) {
-        uuid_destroy(uuid1);
-        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("failed to create UUID object: %s", uuid_error(rc))));
-    }
-    if ((rc = uuid_import(uuid1, UUID_FMT_BIN, uuid_datum1->uuid_bin, sizeof(uuid_datum1->uuid_bin))) != UUID_RC_OK) {
-        uuid_destroy(uuid1);
-        uuid_destroy(uuid2);
-        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("failed to import UUID: %s", uuid_error(rc))));
-    }
-    if ((rc = uuid_import(uuid2, UUID_FMT_BIN, uuid_datum2->uuid_bin, sizeof(uuid_datum2->uuid_bin))) != UUID_RC_OK) {
-        uuid_destroy(uuid1);
-        uuid_destroy(uuid2);
-        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("failed to import UUID: %s", uuid_error(rc))));
-    }
-
-    /* compare UUIDs */
-    if ((rc = uuid_compare(uuid1, uuid2, &result)) != UUID_RC_OK) {
-        uuid_destroy(uuid1);
-        uuid_destroy(uuid2);
-        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
-                errmsg("failed to compare UUID objects: %s", uuid_error(rc))));
-    }
-
-    /* cleanup */
-    uuid_destroy(uuid1);
-    uuid_destroy(uuid2);
+    /* compare UUIDs
+       (the binary representation is in network byte order, so an octet-wise
+       comparison yields the same ordering as uuid_compare(3)) */
+    result = memcmp(uuid_datum1->uuid_bin, uuid_datum2->uuid_bin, UUID_LEN_BIN);
 
     /* return result */
-    return result;
+    return (result < 0 ? -1 : (result > 0 ? 1 : 0));
 }
 
 /* API function: uuid_eq */
@@ -391,7 +511,7 @@ Datum pg_uuid_lt(PG_FUNCTION_ARGS)
     int rc;
 
     rc = _uuid_cmp(fcinfo);
-    PG_RETURN_BOOL(rc == -1);
+    PG_RETURN_BOOL(rc < 0);
 }
 
 /* API function: uuid_gt */
@@ -401,7 +521,7 @@ Datum pg_uuid_gt(PG_FUNCTION_ARGS)
     int rc;
 
     rc = _uuid_cmp(fcinfo);
-    PG_RETURN_BOOL(rc == 1);
+    PG_RETURN_BOOL(rc > 0);
 }
 
 /* API function: uuid_le */
@@ -411,7 +531,7 @@ Datum pg_uuid_le(PG_FUNCTION_ARGS)
     int rc;
 
     rc = _uuid_cmp(fcinfo);
-    PG_RETURN_BOOL(rc < 1);
+    PG_RETURN_BOOL(rc <= 0);
 }
 
 /* API function: uuid_ge */
@@ -421,7 +541,7 @@ Datum pg_uuid_ge(PG_FUNCTION_ARGS)
     int rc;
 
     rc = _uuid_cmp(fcinfo);
-    PG_RETURN_BOOL(rc > -1);
+    PG_RETURN_BOOL(rc >= 0);
 }
 
 /* API function: uuid_cmp */
@@ -434,3 +554,477 @@ Datum pg_uuid_cmp(PG_FUNCTION_ARGS)
     PG_RETURN_INT32(rc);
 }
 
+/* INTERNAL function: sort support comparator on full UUID datums */
+static int _uuid_fastcmp(Datum x, Datum y, SortSupport ssup)
+{
+    uuid_datum_t *uuid_datum1 = (uuid_datum_t *)DatumGetPointer(x);
+    uuid_datum_t *uuid_datum2 = (uuid_datum_t *)DatumGetPointer(y);
+
+    return memcmp(uuid_datum1->uuid_bin, uuid_datum2->uuid_bin, UUID_LEN_BIN);
+}
+
+/* internal sort support state for abbreviated keys */
+typedef struct {
+    int64            input_count;   /* number of values seen */
+    bool             estimating;    /* whether cardinality is still estimated */
+    hyperLogLogState abbr_card;     /* cardinality estimator of abbreviated keys */
+} uuid_sortsupport_t;
+
+/* INTERNAL function: comparator on abbreviated keys */
+static int _uuid_abbrev_cmp(Datum x, Datum y, SortSupport ssup)
+{
+    if (x < y)
+        return -1;
+    else if (x > y)
+        return 1;
+    return 0;
+}
+
+/* INTERNAL function: convert UUID datum into abbreviated key
+   (the leading octets of the UUID as an unsigned integer in native
+   byte order, so that integer comparison matches memcmp(3) order) */
+static Datum _uuid_abbrev_convert(Datum original, SortSupport ssup)
+{
+    uuid_sortsupport_t *uss = (uuid_sortsupport_t *)ssup->ssup_extra;
+    uuid_datum_t *uuid_datum = (uuid_datum_t *)DatumGetPointer(original);
+    Datum res;
+    uint32 tmp;
+    int i;
+
+    res = 0;
+    for (i = 0; i < (int)sizeof(Datum); i++)
+        res = (res << 8) | (Datum)uuid_datum->uuid_bin[i];
+
+    /* feed the cardinality estimator while it is still needed */
+    uss->input_count++;
+    if (uss->estimating) {
+        tmp = (uint32)res;
+        if (sizeof(Datum) > sizeof(uint32))
+            tmp ^= (uint32)((uint64)res >> 32);
+        addHyperLogLog(&uss->abbr_card, DatumGetUInt32(hash_uint32(tmp)));
+    }
+    return res;
+}
+
+/* INTERNAL function: check whether abbreviation is worthwhile
+   (leading octets of random and time based UUIDs are almost always
+   distinct, but a column of UUIDs sharing a common prefix is not) */
+static bool _uuid_abbrev_abort(int memtupcount, SortSupport ssup)
+{
+    uuid_sortsupport_t *uss = (uuid_sortsupport_t *)ssup->ssup_extra;
+    double abbr_card;
+
+    if (memtupcount < 10000 || uss->input_count < 10000 || !uss->estimating)
+        return false;
+    abbr_card = estimateHyperLogLog(&uss->abbr_card);
+
+    /* enough distinct keys seen: stop estimating */
+    if (abbr_card > 100000.0) {
+        uss->estimating = false;
+        return false;
+    }
+
+    /* less than 1 distinct key per 2000 values: abort abbreviation */
+    if (abbr_card < uss->input_count / 2000.0 + 0.5)
+        return true;
+    return false;
+}
+
+/* API function: uuid_sortsupport */
+PG_FUNCTION_INFO_V1(pg_uuid_sortsupport);
+Datum pg_uuid_sortsupport(PG_FUNCTION_ARGS)
+{
+    SortSupport ssup;
+    uuid_sortsupport_t *uss;
+    MemoryContext oldcontext;
+
+    /* sanity check input argument */
+    if ((ssup = (SortSupport)PG_GETARG_POINTER(0)) == NULL)
+        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                errmsg("invalid sort support argument")));
+
+    /* compare full UUIDs without any fmgr overhead */
+    ssup->comparator = _uuid_fastcmp;
+    ssup->ssup_extra = NULL;
+
+    /* compare abbreviated keys first */
+    if (ssup->abbreviate) {
+        oldcontext = MemoryContextSwitchTo(ssup->ssup_cxt);
+        uss = (uuid_sortsupport_t *)palloc(sizeof(uuid_sortsupport_t));
+        uss->input_count = 0;
+        uss->estimating = true;
+        initHyperLogLog(&uss->abbr_card, 10);
+        ssup->ssup_extra = uss;
+        ssup->comparator = _uuid_abbrev_cmp;
+        ssup->abbrev_converter = _uuid_abbrev_convert;
+        ssup->abbrev_abort = _uuid_abbrev_abort;
+        ssup->abbrev_full_comparator = _uuid_fastcmp;
+        MemoryContextSwitchTo(oldcontext);
+    }
+
+    PG_RETURN_VOID();
+}
+
+/* offset between UUID (1582-10-15) and Unix (1970-01-01) Epoch in microseconds */
+#define UUID_TIMEOFFSET_USEC INT64CONST(12219292800000000)
+
+/* offset between Unix (1970-01-01) and PostgreSQL (2000-01-01) Epoch in microseconds */
+#define UUID_PGOFFSET_USEC   ((int64)(POSTGRES_EPOCH_JDATE - UNIX_EPOCH_JDATE) * USECS_PER_DAY)
+
+/* INTERNAL function: extract timestamp out of time based UUID
+   (version 1 and 6: 60 bit of 100 nsec since UUID Epoch,
+   version 7: 48 bit of msec since Unix Epoch) */
+static int _uuid_time(const unsigned char *bin, TimestampTz *ts)
+{
+    uint64 t;
+    int64 usec;
+
+    /* only DCE 1.1 variant UUIDs have a defined layout */
+    if ((bin[8] & 0xc0) != 0x80)
+        return 0;
+    switch (bin[6] >> 4) {
+        case 1:
+            t =   ((uint64)(bin[6] & 0x0f) << 56) | ((uint64)bin[7] << 48)
+                | ((uint64)bin[4] << 40) | ((uint64)bin[5] << 32)
+                | ((uint64)bin[0] << 24) | ((uint64)bin[1] << 16)
+                | ((uint64)bin[2] <<  8) |  (uint64)bin[3];
+            usec = (int64)(t / 10) - UUID_TIMEOFFSET_USEC;
+            break;
+        case 6:
+            t =   ((uint64)bin[0] << 52) | ((uint64)bin[1] << 44)
+                | ((uint64)bin[2] << 36) | ((uint64)bin[3] << 28)
+                | ((uint64)bin[4] << 20) | ((uint64)bin[5] << 12)
+                | ((uint64)(bin[6] & 0x0f) << 8) | (uint64)bin[7];
+            usec = (int64)(t / 10) - UUID_TIMEOFFSET_USEC;
+            break;
+        case 7:
+            t =   ((uint64)bin[0] << 40) | ((uint64)bin[1] << 32)
+                | ((uint64)bin[2] << 24) | ((uint64)bin[3] << 16)
+                | ((uint64)bin[4] <<  8) |  (uint64)bin[5];
+            usec = (int64)t * 1000;
+            break;
+        default:
+            return 0;
+    }
+    *ts = (TimestampTz)(usec - UUID_PGOFFSET_USEC);
+    return 1;
+}
+
+/* INTERNAL function: build the smallest (upper == 0) or largest
+   (upper == 1) UUID of a version whose timestamp is at least or
+   at most the given one (clamped to the range of the version) */
+static void _uuid_time_bound(int version, TimestampTz ts, int upper, unsigned char *bin)
+{
+    int64 usec_min, usec_max;
+    int64 usec;
+    uint64 t, t_max;
+    int i;
+
+    /* determine timestamp range of version */
+    switch (version) {
+        case 1:
+        case 6:
+            t_max = (UINT64CONST(1) << 60) - 1;
+            usec_min = -UUID_TIMEOFFSET_USEC;
+            usec_max = (int64)(t_max / 10) - UUID_TIMEOFFSET_USEC;
+            break;
+        case 7:
+            t_max = (UINT64CONST(1) << 48) - 1;
+            usec_min = 0;
+            usec_max = (int64)t_max * 1000 + 999;
+            break;
+        default:
+            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                    errmsg("invalid UUID version %d (expected 1, 6 or 7)", version)));
+            return;
+    }
+
+    /* clamp timestamp (including infinity) and convert into Unix Epoch */
+    if (ts < usec_min - UUID_PGOFFSET_USEC)
+        ts = usec_min - UUID_PGOFFSET_USEC;
+    if (ts > usec_max - UUID_PGOFFSET_USEC)
+        ts = usec_max - UUID_PGOFFSET_USEC;
+    usec = ts + UUID_PGOFFSET_USEC;
+
+    /* non-time fields are all zero or all one bits */
+    memset(bin, (upper ? 0xff : 0x00), UUID_LEN_BIN);
+    if (version == 7) {
+        t = (uint64)(usec / 1000);
+        if (!upper && (usec % 1000) != 0 && t < t_max)
+            t++;
+        for (i = 0; i < 6; i++)
+            bin[i] = (unsigned char)(t >> (40 - 8 * i));
+        bin[6] = (unsigned char)(0x70 | (upper ? 0x0f : 0x00));
+    }
+    else {
+        t = (uint64)(usec + UUID_TIMEOFFSET_USEC) * 10 + (upper ? 9 : 0);
+        if (t > t_max)
+            t = t_max;
+        if (version == 1) {
+            bin[0] = (unsigned char)(t >> 24);
+            bin[1] = (unsigned char)(t >> 16);
+            bin[2] = (unsigned char)(t >>  8);
+            bin[3] = (unsigned char)(t      );
+            bin[4] = (unsigned char)(t >> 40);
+            bin[5] = (unsigned char)(t >> 32);
+            bin[6] = (unsigned char)(0x10 | ((t >> 56) & 0x0f));
+            bin[7] = (unsigned char)(t >> 48);
+        }
+        else {
+            for (i = 0; i < 6; i++)
+                bin[i] = (unsigned char)(t >> (52 - 8 * i));
+            bin[6] = (unsigned char)(0x60 | ((t >> 8) & 0x0f));
+            bin[7] = (unsigned char)(t);
+        }
+    }
+
+    /* DCE 1.1 variant */
+    bin[8] = (unsigned char)(upper ? 0xbf : 0x80);
+}
+
+/* API function: uuid_timestamp */
+PG_FUNCTION_INFO_V1(pg_uuid_timestamp);
+Datum pg_uuid_timestamp(PG_FUNCTION_ARGS)
+{
+    uuid_datum_t *uuid_datum;
+    TimestampTz ts;
+
+    /* sanity check input argument */
+    if ((uuid_datum = (uuid_datum_t *)PG_GETARG_POINTER(0)) == NULL)
+        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                errmsg("invalid UUID datum argument")));
+
+    /* return embedded timestamp (or NULL for UUIDs without time) */
+    if (!_uuid_time(uuid_datum->uuid_bin, &ts))
+        PG_RETURN_NULL();
+    PG_RETURN_TIMESTAMPTZ(ts);
+}
+
+/* INTERNAL function: _uuid_time_bound for SQL arguments */
+static Datum _uuid_time_minmax(PG_FUNCTION_ARGS, int upper)
+{
+    uuid_datum_t *uuid_datum;
+
+    if ((uuid_datum = (uuid_datum_t *)palloc(sizeof(uuid_datum_t))) == NULL)
+        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                errmsg("failed to allocate UUID datum")));
+    _uuid_time_bound((int)PG_GETARG_INT32(0), PG_GETARG_TIMESTAMPTZ(1), upper, uuid_datum->uuid_bin);
+    PG_RETURN_POINTER(uuid_datum);
+}
+
+/* API function: uuid_time_min */
+PG_FUNCTION_INFO_V1(pg_uuid_time_min);
+Datum pg_uuid_time_min(PG_FUNCTION_ARGS)
+{
+    return _uuid_time_minmax(fcinfo, 0);
+}
+
+/* API function: uuid_time_max */
+PG_FUNCTION_INFO_V1(pg_uuid_time_max);
+Datum pg_uuid_time_max(PG_FUNCTION_ARGS)
+{
+    return _uuid_time_minmax(fcinfo, 1);
+}
+
+/* INTERNAL function: compare timestamp of UUID with timestamp
+   (returns -2 for UUIDs without time, which never match) */
+static int _uuid_time_cmp(PG_FUNCTION_ARGS)
+{
+    uuid_datum_t *uuid_datum;
+    TimestampTz ts1, ts2;
+
+    /* sanity check input argument */
+    if ((uuid_datum = (uuid_datum_t *)PG_GETARG_POINTER(0)) == NULL)
+        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                errmsg("invalid UUID datum argument")));
+    ts2 = PG_GETARG_TIMESTAMPTZ(1);
+
+    /* compare timestamps */
+    if (!_uuid_time(uuid_datum->uuid_bin, &ts1))
+        return -2;
+    return (ts1 < ts2 ? -1 : (ts1 > ts2 ? 1 : 0));
+}
+
+/* API function: uuid_time_lt */
+PG_FUNCTION_INFO_V1(pg_uuid_time_lt);
+Datum pg_uuid_time_lt(PG_FUNCTION_ARGS)
+{
+    int rc;
+
+    rc = _uuid_time_cmp(fcinfo);
+    PG_RETURN_BOOL(rc == -1);
+}
+
+/* API function: uuid_time_le */
+PG_FUNCTION_INFO_V1(pg_uuid_time_le);
+Datum pg_uuid_time_le(PG_FUNCTION_ARGS)
+{
+    int rc;
+
+    rc = _uuid_time_cmp(fcinfo);
+    PG_RETURN_BOOL(rc == -1 || rc == 0);
+}
+
+/* API function: uuid_time_eq */
+PG_FUNCTION_INFO_V1(pg_uuid_time_eq);
+Datum pg_uuid_time_eq(PG_FUNCTION_ARGS)
+{
+    int rc;
+
+    rc = _uuid_time_cmp(fcinfo);
+    PG_RETURN_BOOL(rc == 0);
+}
+
+/* API function: uuid_time_ge */
+PG_FUNCTION_INFO_V1(pg_uuid_time_ge);
+Datum pg_uuid_time_ge(PG_FUNCTION_ARGS)
+{
+    int rc;
+
+    rc = _uuid_time_cmp(fcinfo);
+    PG_RETURN_BOOL(rc == 0 || rc == 1);
+}
+
+/* API function: uuid_time_gt */
+PG_FUNCTION_INFO_V1(pg_uuid_time_gt);
+Datum pg_uuid_time_gt(PG_FUNCTION_ARGS)
+{
+    int rc;
+
+    rc = _uuid_time_cmp(fcinfo);
+    PG_RETURN_BOOL(rc == 1);
+}
+
+/* BRIN strategy numbers of the time operators */
+#define UUID_BRIN_TIME_LT 1
+#define UUID_BRIN_TIME_LE 2
+#define UUID_BRIN_TIME_EQ 3
+#define UUID_BRIN_TIME_GE 4
+#define UUID_BRIN_TIME_GT 5
+
+/* API function: uuid_brin_time_opcinfo
+   (summarizes a block range by the minimum and maximum embedded timestamp;
+   UUIDs without time never match the time operators, so they only turn an
+   all-NULL summary into the empty interval from +infinity to -infinity,
+   which is not all-NULL but consistent with no timestamp at all) */
+PG_FUNCTION_INFO_V1(pg_uuid_brin_time_opcinfo);
+Datum pg_uuid_brin_time_opcinfo(PG_FUNCTION_ARGS)
+{
+    BrinOpcInfo *result;
+
+    result = (BrinOpcInfo *)palloc0(MAXALIGN(SizeofBrinOpcInfo(2)));
+    result->oi_nstored = 2;
+#if PG_VERSION_NUM >= 140000
+    result->oi_regular_nulls = true;
+#endif
+    result->oi_opaque = NULL;
+    result->oi_typcache[0] = result->oi_typcache[1] = lookup_type_cache(TIMESTAMPTZOID, 0);
+    PG_RETURN_POINTER(result);
+}
+
+/* API function: uuid_brin_time_add_value */
+PG_FUNCTION_INFO_V1(pg_uuid_brin_time_add_value);
+Datum pg_uuid_brin_time_add_value(PG_FUNCTION_ARGS)
+{
+    BrinValues *column = (BrinValues *)PG_GETARG_POINTER(1);
+    Datum newval = PG_GETARG_DATUM(2);
+    bool isnull = (PG_NARGS() > 3 ? PG_GETARG_BOOL(3) : false);
+    TimestampTz ts;
+    bool updated;
+
+    /* NULL values (handled by BRIN itself since PostgreSQL 14) */
+    if (isnull) {
+        if (column->bv_hasnulls)
+            PG_RETURN_BOOL(false);
+        column->bv_hasnulls = true;
+        PG_RETURN_BOOL(true);
+    }
+
+    /* the range holds a non-NULL value: start with the empty interval */
+    updated = false;
+    if (column->bv_allnulls) {
+        column->bv_values[0] = TimestampTzGetDatum(DT_NOEND);
+        column->bv_values[1] = TimestampTzGetDatum(DT_NOBEGIN);
+        column->bv_allnulls = false;
+        updated = true;
+    }
+
+    /* extend the summarized range of timestamps */
+    if (!_uuid_time(((uuid_datum_t *)DatumGetPointer(newval))->uuid_bin, &ts))
+        PG_RETURN_BOOL(updated);
+    if (ts < DatumGetTimestampTz(column->bv_values[0])) {
+        column->bv_values[0] = TimestampTzGetDatum(ts);
+        updated = true;
+    }
+    if (ts > DatumGetTimestampTz(column->bv_values[1])) {
+        column->bv_values[1] = TimestampTzGetDatum(ts);
+        updated = true;
+    }
+    PG_RETURN_BOOL(updated);
+}
+
+/* API function: uuid_brin_time_consistent */
+PG_FUNCTION_INFO_V1(pg_uuid_brin_time_consistent);
+Datum pg_uuid_brin_time_consistent(PG_FUNCTION_ARGS)
+{
+    BrinValues *column = (BrinValues *)PG_GETARG_POINTER(1);
+    ScanKey key = (ScanKey)PG_GETARG_POINTER(2);
+    TimestampTz ts_min, ts_max, ts;
+
+    /* IS [NOT] NULL searches (handled by BRIN itself since PostgreSQL 14) */
+    if (key->sk_flags & SK_ISNULL) {
+        if (key->sk_flags & SK_SEARCHNULL)
+            PG_RETURN_BOOL(column->bv_allnulls || column->bv_hasnulls);
+        if (key->sk_flags & SK_SEARCHNOTNULL)
+            PG_RETURN_BOOL(!column->bv_allnulls);
+        PG_RETURN_BOOL(false);
+    }
+    if (column->bv_allnulls)
+        PG_RETURN_BOOL(false);
+
+    /* check timestamp against summarized range
+       (the empty interval of UUIDs without time never matches) */
+    ts_min = DatumGetTimestampTz(column->bv_values[0]);
+    ts_max = DatumGetTimestampTz(column->bv_values[1]);
+    ts = DatumGetTimestampTz(key->sk_argument);
+    switch (key->sk_strategy) {
+        case UUID_BRIN_TIME_LT: PG_RETURN_BOOL(ts_min <  ts);
+        case UUID_BRIN_TIME_LE: PG_RETURN_BOOL(ts_min <= ts);
+        case UUID_BRIN_TIME_EQ: PG_RETURN_BOOL(ts_min <= ts && ts <= ts_max);
+        case UUID_BRIN_TIME_GE: PG_RETURN_BOOL(ts_max >= ts);
+        case UUID_BRIN_TIME_GT: PG_RETURN_BOOL(ts_max >  ts);
+        default:
+            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION),
+                    errmsg("invalid BRIN strategy number %d", (int)key->sk_strategy)));
+    }
+    PG_RETURN_BOOL(false);
+}
+
+/* API function: uuid_brin_time_union */
+PG_FUNCTION_INFO_V1(pg_uuid_brin_time_union);
+Datum pg_uuid_brin_time_union(PG_FUNCTION_ARGS)
+{
+    BrinValues *col_a = (BrinValues *)PG_GETARG_POINTER(1);
+    BrinValues *col_b = (BrinValues *)PG_GETARG_POINTER(2);
+
+    /* merge NULL information */
+    if (col_b->bv_hasnulls)
+        col_a->bv_hasnulls = true;
+    if (col_b->bv_allnulls)
+        PG_RETURN_VOID();
+    if (col_a->bv_allnulls) {
+        col_a->bv_values[0] = col_b->bv_values[0];
+        col_a->bv_values[1] = col_b->bv_values[1];
+        col_a->bv_allnulls = false;
+        PG_RETURN_VOID();
+    }
+
+    /* merge timestamp ranges
+       (the empty interval is the neutral element of this merge) */
+    if (DatumGetTimestampTz(col_b->bv_values[0]) < DatumGetTimestampTz(col_a->bv_values[0]))
+        col_a->bv_values[0] = col_b->bv_values[0];
+    if (DatumGetTimestampTz(col_b->bv_values[1]) > DatumGetTimestampTz(col_a->bv_values[1]))
+        col_a->bv_values[1] = col_b->bv_values[1];
+    PG_RETURN_VOID();
+}
+
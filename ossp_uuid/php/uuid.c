@@ -31,6 +31,8 @@
 #include "config.h"
 #endif
 
+#include <unistd.h>
+
 #include "uuid.h"
 #include "php.h"
 #include "ext/standard/info.h"
@@ -59,9 +61,101 @@ static void ctx_destructor(zend_rsrc_list_entry *rsrc TSRMLS_DC)
 static int ctx_id;               /* internal number */
 #define ctx_name "UUID context"  /* external name   */
 
+/* module globals (per process, or per thread under ZTS) */
+ZEND_BEGIN_MODULE_GLOBALS(uuid)
+    uuid_t *gen;      /* lazily created generator, kept across requests */
+    pid_t   gen_pid;  /* process which created it (re-create after fork) */
+ZEND_END_MODULE_GLOBALS(uuid)
+
+ZEND_DECLARE_MODULE_GLOBALS(uuid)
+
+#ifdef ZTS
+#define UUID_G(v) TSRMG(uuid_globals_id, zend_uuid_globals *, v)
+#else
+#define UUID_G(v) (uuid_globals.v)
+#endif
+
+/* module globals construction */
+static void uuid_init_globals(zend_uuid_globals *uuid_globals TSRMLS_DC)
+{
+    uuid_globals->gen     = NULL;
+    uuid_globals->gen_pid = 0;
+    return;
+}
+
+/* module globals destruction */
+static void uuid_shutdown_globals(zend_uuid_globals *uuid_globals TSRMLS_DC)
+{
+    if (uuid_globals->gen != NULL) {
+        uuid_destroy(uuid_globals->gen);
+        uuid_globals->gen = NULL;
+    }
+    return;
+}
+
+/* fetch the module global generator, creating it on first use */
+static uuid_t *gen_fetch(TSRMLS_D)
+{
+    uuid_rc_t rc;
+
+    /* a generator inherited over fork(2) would repeat the PRNG
+       and time state of its sibling processes */
+    if (UUID_G(gen) != NULL && UUID_G(gen_pid) != getpid()) {
+        uuid_destroy(UUID_G(gen));
+        UUID_G(gen) = NULL;
+    }
+    if (UUID_G(gen) == NULL) {
+        if ((rc = uuid_create(&UUID_G(gen))) != UUID_RC_OK) {
+            php_error_docref(NULL TSRMLS_CC, E_WARNING, "uuid_create: %s", uuid_error(rc));
+            UUID_G(gen) = NULL;
+            return NULL;
+        }
+        UUID_G(gen_pid) = getpid();
+    }
+    return UUID_G(gen);
+}
+
+/* map a UUID version number onto a uuid_make() mode (or 0) */
+static unsigned long gen_mode(long version)
+{
+    switch (version) {
+        case 1:  return UUID_MAKE_V1;
+        case 4:  return UUID_MAKE_V4;
+        case 7:  return UUID_MAKE_V7;
+        default: return 0;
+    }
+}
+
+/* make a UUID with the module global generator and export it into
+   the caller supplied buffer (which has to hold UUID_LEN_SIV+1 octets) */
+static uuid_rc_t gen_make(unsigned long mode, uuid_fmt_t fmt,
+                          char *buf, size_t *len TSRMLS_DC)
+{
+    uuid_t *gen;
+    void *data_ptr;
+    uuid_rc_t rc;
+
+    if ((gen = gen_fetch(TSRMLS_C)) == NULL)
+        return UUID_RC_MEM;
+    if ((rc = uuid_make(gen, mode)) != UUID_RC_OK)
+        return rc;
+    data_ptr = buf;
+    *len = UUID_LEN_SIV+1;
+    if ((rc = uuid_export(gen, fmt, &data_ptr, len)) != UUID_RC_OK)
+        return rc;
+    if (fmt == UUID_FMT_SIV)
+        *len = strlen(buf);
+    else if (fmt != UUID_FMT_BIN)
+        (*len)--; /* PHP doesn't wish NUL-termination on strings */
+    return UUID_RC_OK;
+}
+
 /* module initialization */
 PHP_MINIT_FUNCTION(uuid)
 {
+    /* initialize module globals */
+    ZEND_INIT_MODULE_GLOBALS(uuid, uuid_init_globals, uuid_shutdown_globals);
+
     /* register resource identifier */
     ctx_id = zend_register_list_destructors_ex(
         ctx_destructor, NULL, ctx_name, module_number);
@@ -71,6 +165,10 @@ PHP_MINIT_FUNCTION(uuid)
     REGISTER_LONG_CONSTANT("UUID_LEN_BIN", UUID_LEN_BIN, CONST_CS|CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("UUID_LEN_STR", UUID_LEN_STR, CONST_CS|CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("UUID_LEN_SIV", UUID_LEN_SIV, CONST_CS|CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("UUID_LEN_B64", UUID_LEN_B64, CONST_CS|CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("UUID_LEN_B32", UUID_LEN_B32, CONST_CS|CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("UUID_LEN_B58", UUID_LEN_B58, CONST_CS|CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("UUID_LEN_ULID", UUID_LEN_ULID, CONST_CS|CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("UUID_RC_OK",   UUID_RC_OK,   CONST_CS|CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("UUID_RC_ARG",  UUID_RC_ARG,  CONST_CS|CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("UUID_RC_MEM",  UUID_RC_MEM,  CONST_CS|CONST_PERSISTENT);
@@ -82,10 +180,16 @@ PHP_MINIT_FUNCTION(uuid)
     REGISTER_LONG_CONSTANT("UUID_MAKE_V4", UUID_MAKE_V4, CONST_CS|CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("UUID_MAKE_V5", UUID_MAKE_V5, CONST_CS|CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("UUID_MAKE_MC", UUID_MAKE_MC, CONST_CS|CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("UUID_MAKE_V7", UUID_MAKE_V7, CONST_CS|CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("UUID_MAKE_ULID", UUID_MAKE_ULID, CONST_CS|CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("UUID_FMT_BIN", UUID_FMT_BIN, CONST_CS|CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("UUID_FMT_STR", UUID_FMT_STR, CONST_CS|CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("UUID_FMT_SIV", UUID_FMT_SIV, CONST_CS|CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("UUID_FMT_TXT", UUID_FMT_TXT, CONST_CS|CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("UUID_FMT_B64", UUID_FMT_B64, CONST_CS|CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("UUID_FMT_B32", UUID_FMT_B32, CONST_CS|CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("UUID_FMT_B58", UUID_FMT_B58, CONST_CS|CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("UUID_FMT_ULID", UUID_FMT_ULID, CONST_CS|CONST_PERSISTENT);
 
     return SUCCESS;
 }
@@ -93,6 +197,10 @@ PHP_MINIT_FUNCTION(uuid)
 /* module shutdown */
 PHP_MSHUTDOWN_FUNCTION(uuid)
 {
+#ifndef ZTS
+    /* destroy module globals (done by TSRM itself under ZTS) */
+    uuid_shutdown_globals(&uuid_globals TSRMLS_CC);
+#endif
     return SUCCESS;
 }
 
@@ -460,7 +568,7 @@ PHP_FUNCTION(uuid_export)
     }
     if (fmt == UUID_FMT_SIV)
         data_len = strlen((char *)data_ptr);
-    else if (fmt == UUID_FMT_STR || fmt == UUID_FMT_TXT)
+    else if (fmt != UUID_FMT_BIN)
         data_len--; /* PHP doesn't wish NUL-termination on strings */
     ZVAL_STRINGL(z_data, data_ptr, data_len, 1);
     free(data_ptr);
@@ -495,6 +603,93 @@ PHP_FUNCTION(uuid_version)
     RETURN_LONG((long)uuid_version());
 }
 
+/* INTERNAL: single-call generation with the module global generator */
+static void gen_quick(INTERNAL_FUNCTION_PARAMETERS, unsigned long mode, uuid_fmt_t fmt)
+{
+    char buf[UUID_LEN_SIV+1];
+    size_t len;
+    uuid_rc_t rc;
+
+    if (ZEND_NUM_ARGS() != 0)
+        WRONG_PARAM_COUNT;
+    if ((rc = gen_make(mode, fmt, buf, &len TSRMLS_CC)) != UUID_RC_OK) {
+        php_error_docref(NULL TSRMLS_CC, E_WARNING, "uuid_make: %s", uuid_error(rc));
+        RETURN_FALSE;
+    }
+    RETURN_STRINGL(buf, len, 1);
+}
+
+/* API FUNCTIONS:
+   proto string uuid_v{1,4,7}_{str,bin}()
+   $str = uuid_v4_str();
+   make a new UUID with the module global generator and return it
+   in string or binary representation (or FALSE on error) */
+PHP_FUNCTION(uuid_v1_str) { gen_quick(INTERNAL_FUNCTION_PARAM_PASSTHRU, UUID_MAKE_V1, UUID_FMT_STR); }
+PHP_FUNCTION(uuid_v1_bin) { gen_quick(INTERNAL_FUNCTION_PARAM_PASSTHRU, UUID_MAKE_V1, UUID_FMT_BIN); }
+PHP_FUNCTION(uuid_v4_str) { gen_quick(INTERNAL_FUNCTION_PARAM_PASSTHRU, UUID_MAKE_V4, UUID_FMT_STR); }
+PHP_FUNCTION(uuid_v4_bin) { gen_quick(INTERNAL_FUNCTION_PARAM_PASSTHRU, UUID_MAKE_V4, UUID_FMT_BIN); }
+PHP_FUNCTION(uuid_v7_str) { gen_quick(INTERNAL_FUNCTION_PARAM_PASSTHRU, UUID_MAKE_V7, UUID_FMT_STR); }
+PHP_FUNCTION(uuid_v7_bin) { gen_quick(INTERNAL_FUNCTION_PARAM_PASSTHRU, UUID_MAKE_V7, UUID_FMT_BIN); }
+
+/* API FUNCTIONS:
+   proto string uuid_ulid_{str,bin}()
+   $str = uuid_ulid_str();
+   make a new (monotonic) ULID with the module global generator and
+   return it in ULID or binary representation (or FALSE on error) */
+PHP_FUNCTION(uuid_ulid_str) { gen_quick(INTERNAL_FUNCTION_PARAM_PASSTHRU, UUID_MAKE_ULID, UUID_FMT_ULID); }
+PHP_FUNCTION(uuid_ulid_bin) { gen_quick(INTERNAL_FUNCTION_PARAM_PASSTHRU, UUID_MAKE_ULID, UUID_FMT_BIN); }
+
+/* API FUNCTION:
+   proto array uuid_generate_many(version, n[, fmt])
+   $list = uuid_generate_many(7, 1000, UUID_FMT_STR);
+   make n new UUIDs of version 1, 4 or 7 with the module global
+   generator and return them as an array (or FALSE on error) */
+PHP_FUNCTION(uuid_generate_many)
+{
+    long z_version;
+    long z_n;
+    long z_fmt = UUID_FMT_STR;
+    unsigned long mode;
+    uuid_fmt_t fmt;
+    char buf[UUID_LEN_SIV+1];
+    size_t len;
+    uuid_rc_t rc;
+    long i;
+
+    /* parse parameters */
+    if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "ll|l", &z_version, &z_n, &z_fmt) == FAILURE)
+        RETURN_FALSE;
+
+    /* post-process and sanity check parameters */
+    if ((mode = gen_mode(z_version)) == 0) {
+        php_error_docref(NULL TSRMLS_CC, E_WARNING, "uuid_generate_many: invalid version (expected 1, 4 or 7)");
+        RETURN_FALSE;
+    }
+    if (z_n < 0) {
+        php_error_docref(NULL TSRMLS_CC, E_WARNING, "uuid_generate_many: invalid count");
+        RETURN_FALSE;
+    }
+    fmt = (uuid_fmt_t)z_fmt;
+    if (   fmt != UUID_FMT_BIN && fmt != UUID_FMT_STR && fmt != UUID_FMT_SIV
+        && fmt != UUID_FMT_B64 && fmt != UUID_FMT_B32 && fmt != UUID_FMT_B58
+        && fmt != UUID_FMT_ULID) {
+        php_error_docref(NULL TSRMLS_CC, E_WARNING, "uuid_generate_many: invalid format");
+        RETURN_FALSE;
+    }
+
+    /* perform operation */
+    array_init(return_value);
+    for (i = 0; i < z_n; i++) {
+        if ((rc = gen_make(mode, fmt, buf, &len TSRMLS_CC)) != UUID_RC_OK) {
+            php_error_docref(NULL TSRMLS_CC, E_WARNING, "uuid_generate_many: %s", uuid_error(rc));
+            zval_dtor(return_value);
+            RETURN_FALSE;
+        }
+        add_next_index_stringl(return_value, buf, len, 1);
+    }
+    return;
+}
+
 /* module function table */
 static function_entry uuid_functions[] = {
     PHP_FE(uuid_create,  NULL)
@@ -508,6 +703,15 @@ static function_entry uuid_functions[] = {
     PHP_FE(uuid_export,  NULL)
     PHP_FE(uuid_error,   NULL)
     PHP_FE(uuid_version, NULL)
+    PHP_FE(uuid_v1_str,  NULL)
+    PHP_FE(uuid_v1_bin,  NULL)
+    PHP_FE(uuid_v4_str,  NULL)
+    PHP_FE(uuid_v4_bin,  NULL)
+    PHP_FE(uuid_v7_str,  NULL)
+    PHP_FE(uuid_v7_bin,  NULL)
+    PHP_FE(uuid_ulid_str, NULL)
+    PHP_FE(uuid_ulid_bin, NULL)
+    PHP_FE(uuid_generate_many, NULL)
     { NULL, NULL, NULL }
 };
 
@@ -121,6 +121,33 @@ assert('$str != "quux"');
 #assert('$str == "02d9e6d5-9467-382e-8f9b-9300a64ac3cd"');
 print "UUID: $str\n";
 
+print "++ testing single-call API:\n";
+
+$str = uuid_v4_str();
+assert('strlen($str) == UUID_LEN_STR');
+print "UUID: $str\n";
+
+$bin = uuid_v7_bin();
+assert('strlen($bin) == UUID_LEN_BIN');
+
+$list = uuid_generate_many(7, 100, UUID_FMT_STR);
+assert('count($list) == 100');
+assert('count(array_unique($list)) == 100');
+$sorted = $list;
+sort($sorted);
+assert('$sorted === $list');
+
+$list = uuid_generate_many(7, 100, UUID_FMT_B32);
+assert('strlen($list[0]) == UUID_LEN_B32');
+$sorted = $list;
+sort($sorted);
+assert('$sorted === $list');
+
+$str1 = uuid_ulid_str();
+$str2 = uuid_ulid_str();
+assert('strlen($str1) == UUID_LEN_ULID');
+assert('strcmp($str1, $str2) < 0');
+
 ##
 ##  HIGH-LEVEL API TESTING
 ##
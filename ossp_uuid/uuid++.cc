@@ -140,7 +140,7 @@ uuid &uuid::operator=(const char *str)
 /*  method: clone object */
 uuid uuid::clone(void)
 {
-    return new uuid(this);
+    return uuid(*this);
 }
 
 /*  method: loading existing UUID by name */
@@ -253,6 +253,17 @@ void uuid::import(const char *str)
     return;
 }
 
+/*  method: import string representation of a particular format */
+void uuid::import(const char *str, uuid_fmt_t fmt)
+{
+    uuid_rc_t rc;
+    if (str == NULL || fmt == UUID_FMT_BIN)
+        throw uuid_error_t(UUID_RC_ARG);
+    if ((rc = uuid_import(ctx, fmt, str, strlen(str))) != UUID_RC_OK)
+        throw uuid_error_t(rc);
+    return;
+}
+
 /*  method: export binary representation */
 void *uuid::binary(void)
 {
@@ -273,6 +284,18 @@ char *uuid::string(void)
     return str;
 }
 
+/*  method: export string representation of a particular format */
+char *uuid::string(uuid_fmt_t fmt)
+{
+    uuid_rc_t rc;
+    char *str = NULL;
+    if (fmt == UUID_FMT_BIN)
+        throw uuid_error_t(UUID_RC_ARG);
+    if ((rc = uuid_export(ctx, fmt, (void **)&str, NULL)) != UUID_RC_OK)
+        throw uuid_error_t(rc);
+    return str;
+}
+
 /*  method: export single integer value representation */
 char *uuid::integer(void)
 {
@@ -299,3 +322,92 @@ unsigned long uuid::version(void)
     return uuid_version();
 }
 
+#ifdef UUIDXX_HAVE_VALUE_API
+
+/*  UUID value: extra constructor via C API object */
+ossp::uuid::uuid(const uuid_t *obj)
+{
+    uuid_rc_t rc;
+    void *bin = octets.data();
+    size_t len = octets.size();
+    if (obj == NULL)
+        throw uuid_error_t(UUID_RC_ARG);
+    if ((rc = uuid_export(obj, UUID_FMT_BIN, &bin, &len)) != UUID_RC_OK)
+        throw uuid_error_t(rc);
+    return;
+}
+
+/*  UUID generator: standard constructor */
+ossp::uuid_generator::uuid_generator()
+{
+    uuid_rc_t rc;
+    ns = NULL;
+    if ((rc = uuid_create(&ctx)) != UUID_RC_OK)
+        throw uuid_error_t(rc);
+    return;
+}
+
+/*  UUID generator: move constructor */
+ossp::uuid_generator::uuid_generator(uuid_generator &&obj) noexcept
+{
+    ctx = obj.ctx;
+    ns  = obj.ns;
+    obj.ctx = NULL;
+    obj.ns  = NULL;
+    return;
+}
+
+/*  UUID generator: standard destructor */
+ossp::uuid_generator::~uuid_generator()
+{
+    if (ns != NULL)
+        uuid_destroy(ns);
+    if (ctx != NULL)
+        uuid_destroy(ctx);
+    return;
+}
+
+/*  UUID generator: move assignment operator */
+ossp::uuid_generator &ossp::uuid_generator::operator=(uuid_generator &&obj) noexcept
+{
+    if (this == &obj)
+        return *this;
+    if (ns != NULL)
+        uuid_destroy(ns);
+    if (ctx != NULL)
+        uuid_destroy(ctx);
+    ctx = obj.ctx;
+    ns  = obj.ns;
+    obj.ctx = NULL;
+    obj.ns  = NULL;
+    return *this;
+}
+
+/*  UUID generator: making new time or random based UUID */
+ossp::uuid ossp::uuid_generator::make(unsigned int mode)
+{
+    uuid_rc_t rc;
+    if (ctx == NULL || (mode & (UUID_MAKE_V3|UUID_MAKE_V5)))
+        throw uuid_error_t(UUID_RC_ARG);
+    if ((rc = uuid_make(ctx, mode)) != UUID_RC_OK)
+        throw uuid_error_t(rc);
+    return uuid(ctx);
+}
+
+/*  UUID generator: making new name based UUID */
+ossp::uuid ossp::uuid_generator::make(unsigned int mode, const uuid &nsid, const char *name)
+{
+    uuid_rc_t rc;
+    if (ctx == NULL || name == NULL || !(mode & (UUID_MAKE_V3|UUID_MAKE_V5)))
+        throw uuid_error_t(UUID_RC_ARG);
+    if (ns == NULL)
+        if ((rc = uuid_create(&ns)) != UUID_RC_OK)
+            throw uuid_error_t(rc);
+    if ((rc = uuid_import(ns, UUID_FMT_BIN, nsid.data(), nsid.size())) != UUID_RC_OK)
+        throw uuid_error_t(rc);
+    if ((rc = uuid_make(ctx, mode, ns, name)) != UUID_RC_OK)
+        throw uuid_error_t(rc);
+    return uuid(ctx);
+}
+
+#endif /* UUIDXX_HAVE_VALUE_API */
@@ -69,8 +69,10 @@ class uuid {
         /* content importing & exporting */
         void          import       (const void *_bin);         /* regular method */
         void          import       (const char *_str);         /* regular method */
+        void          import       (const char *_str, uuid_fmt_t _fmt); /* regular method */
         void         *binary       (void);                     /* regular method */
         char         *string       (void);                     /* regular method */
+        char         *string       (uuid_fmt_t _fmt);          /* regular method */
         char         *integer      (void);                     /* regular method */
         char         *summary      (void);                     /* regular method */
 
@@ -94,5 +96,647 @@ class uuid_error_t {
         uuid_rc_t rc;
 };
 
+/* value-semantic API (requires ISO C++17) */
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define UUIDXX_HAVE_VALUE_API 1
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__cpp_lib_span) || (__cplusplus >= 202002L && __has_include(<span>))
+#include <span>
+#define UUIDXX_HAVE_SPAN 1
+#endif
+#if defined(__cpp_impl_three_way_comparison) && __cpp_impl_three_way_comparison >= 201907L && __has_include(<compare>)
+#include <compare>
+#define UUIDXX_HAVE_THREE_WAY 1
+#endif
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace ossp {
+
+/* UUID value class: plain 16 octets in network byte order,
+   trivially copyable and free of any allocations */
+class uuid {
+    public:
+        typedef std::array<std::uint8_t, UUID_LEN_BIN> bytes_type;
+
+        /* construction */
+        constexpr     uuid         () noexcept : octets() {}   /* Nil UUID */
+        constexpr explicit uuid    (const bytes_type &_bytes) noexcept : octets(_bytes) {}
+        explicit      uuid         (const uuid_t *_obj);       /* import from C API object */
+
+        static uuid   from_bytes   (const void *_bin) noexcept {
+                          uuid u; std::memcpy(u.octets.data(), _bin, UUID_LEN_BIN); return u; }
+
+        /* content access */
+        constexpr const bytes_type &bytes (void) const noexcept { return octets; }
+        const std::uint8_t *data   (void) const noexcept      { return octets.data(); }
+        static constexpr std::size_t size(void) noexcept      { return UUID_LEN_BIN; }
+        constexpr bool isnil       (void) const noexcept {
+                          for (std::size_t i = 0; i < UUID_LEN_BIN; i++)
+                              if (octets[i] != 0)
+                                  return false;
+                          return true; }
+        constexpr unsigned int version(void) const noexcept { return (unsigned int)(octets[6] >> 4); }
+
+        /* content as two 64-bit words in network byte order (_i = 0 or 1),
+           i.e. numerically ordered the same way as the octets */
+        constexpr std::uint64_t word(std::size_t _i) const noexcept {
+                          std::uint64_t w = 0;
+                          for (std::size_t i = _i * 8; i < _i * 8 + 8; i++)
+                              w = (w << 8) | octets[i];
+                          return w; }
+
+        /* content comparison (same ordering as uuid_compare(3)) */
+        static constexpr int compare(const uuid &_a, const uuid &_b) noexcept {
+                          if (_a.word(0) != _b.word(0))
+                              return (_a.word(0) < _b.word(0) ? -1 : +1);
+                          if (_a.word(1) != _b.word(1))
+                              return (_a.word(1) < _b.word(1) ? -1 : +1);
+                          return 0; }
+        friend constexpr bool operator== (const uuid &_a, const uuid &_b) noexcept { return compare(_a, _b) == 0; }
+        friend constexpr bool operator!= (const uuid &_a, const uuid &_b) noexcept { return compare(_a, _b) != 0; }
+        friend constexpr bool operator<  (const uuid &_a, const uuid &_b) noexcept { return compare(_a, _b) <  0; }
+        friend constexpr bool operator<= (const uuid &_a, const uuid &_b) noexcept { return compare(_a, _b) <= 0; }
+        friend constexpr bool operator>  (const uuid &_a, const uuid &_b) noexcept { return compare(_a, _b) >  0; }
+        friend constexpr bool operator>= (const uuid &_a, const uuid &_b) noexcept { return compare(_a, _b) >= 0; }
+#ifdef UUIDXX_HAVE_THREE_WAY
+        friend constexpr std::strong_ordering operator<=> (const uuid &_a, const uuid &_b) noexcept {
+                          if (_a.word(0) != _b.word(0))
+                              return _a.word(0) <=> _b.word(0);
+                          return _a.word(1) <=> _b.word(1); }
+#endif
+
+    private:
+        bytes_type octets;
+};
+
+static_assert(sizeof(uuid) == UUID_LEN_BIN, "ossp::uuid has to be exactly 16 octets");
+static_assert(std::is_trivially_copyable<uuid>::value, "ossp::uuid has to be trivially copyable");
+static_assert(std::is_nothrow_move_constructible<uuid>::value, "ossp::uuid has to be nothrow movable");
+
+/* format UUID into caller buffer as string representation (UUID_LEN_STR
+   characters, no NUL termination) in the style of std::to_chars */
+constexpr std::to_chars_result to_chars(char *_first, char *_last, const uuid &_u) noexcept
+{
+    const char *hex = "0123456789abcdef";
+    const uuid::bytes_type &b = _u.bytes();
+    std::size_t i = 0;
+
+    if (_last - _first < UUID_LEN_STR)
+        return std::to_chars_result{ _last, std::errc::value_too_large };
+    for (i = 0; i < UUID_LEN_BIN; i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10)
+            *_first++ = '-';
+        *_first++ = hex[b[i] >> 4];
+        *_first++ = hex[b[i] & 0x0f];
+    }
+    return std::to_chars_result{ _first, std::errc() };
+}
+
+namespace detail {
+    /* value of a hexadecimal digit (or -1) */
+    constexpr int hexval(char _c) noexcept {
+        return (_c >= '0' && _c <= '9') ? (_c - '0')
+             : (_c >= 'a' && _c <= 'f') ? (_c - 'a' + 10)
+             : (_c >= 'A' && _c <= 'F') ? (_c - 'A' + 10) : -1;
+    }
+}
+
+/* parse UUID from string representation in the style of std::from_chars
+   (usable in constant expressions) */
+constexpr std::from_chars_result from_chars(const char *_first, const char *_last, uuid &_u) noexcept
+{
+    uuid::bytes_type b = {};
+    const char *cp = _first;
+    std::size_t i = 0;
+    int hi = 0, lo = 0;
+
+    if (_last - _first < UUID_LEN_STR)
+        return std::from_chars_result{ _first, std::errc::invalid_argument };
+    for (i = 0; i < UUID_LEN_BIN; i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) {
+            if (*cp++ != '-')
+                return std::from_chars_result{ _first, std::errc::invalid_argument };
+        }
+        hi = detail::hexval(*cp++);
+        lo = detail::hexval(*cp++);
+        if (hi < 0 || lo < 0)
+            return std::from_chars_result{ _first, std::errc::invalid_argument };
+        b[i] = (std::uint8_t)((hi << 4) | lo);
+    }
+    _u = uuid(b);
+    return std::from_chars_result{ cp, std::errc() };
+}
+
+/* format UUID as string representation */
+inline std::string to_string(const uuid &_u)
+{
+    char buf[UUID_LEN_STR];
+    (void)to_chars(buf, buf + sizeof(buf), _u);
+    return std::string(buf, sizeof(buf));
+}
+
+/* user-defined literal for UUIDs in string representation,
+   validated at compile-time ("6ba7b810-9dad-11d1-80b4-00c04fd430c8"_uuid) */
+#if defined(__cpp_consteval)
+#define UUIDXX_CONSTEVAL consteval
+#else
+#define UUIDXX_CONSTEVAL constexpr
+#endif
+namespace literals {
+    UUIDXX_CONSTEVAL uuid operator""_uuid(const char *_str, std::size_t _len)
+    {
+        uuid u;
+        if (_len != UUID_LEN_STR || from_chars(_str, _str + _len, u).ec != std::errc())
+            throw uuid_error_t(UUID_RC_ARG);
+        return u;
+    }
+}
+
+/* pre-defined UUID values (corresponding to uuid_load(3) names) */
+namespace ns {
+    using namespace ossp::literals;
+    inline constexpr uuid nil  = "00000000-0000-0000-0000-000000000000"_uuid; /* "nil"     */
+    inline constexpr uuid dns  = "6ba7b810-9dad-11d1-80b4-00c04fd430c8"_uuid; /* "ns:DNS"  */
+    inline constexpr uuid url  = "6ba7b811-9dad-11d1-80b4-00c04fd430c8"_uuid; /* "ns:URL"  */
+    inline constexpr uuid oid  = "6ba7b812-9dad-11d1-80b4-00c04fd430c8"_uuid; /* "ns:OID"  */
+    inline constexpr uuid x500 = "6ba7b814-9dad-11d1-80b4-00c04fd430c8"_uuid; /* "ns:X500" */
+}
+
+namespace detail {
+    /* MD5 (IETF RFC 1321) and SHA-1 (IETF RFC 3174) message digests over
+       the concatenation of a namespace UUID and a name, usable in constant
+       expressions (the C API uses uuid_md5.c and uuid_sha1.c instead) */
+    inline constexpr std::uint32_t md5_k[64] = {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+        0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+        0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+        0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+        0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+        0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+        0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+        0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+        0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+    };
+    inline constexpr int md5_s[16] = {
+        7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21
+    };
+
+    constexpr std::uint32_t rotl(std::uint32_t _x, int _n) noexcept {
+        return (std::uint32_t)((_x << _n) | (_x >> (32 - _n)));
+    }
+
+    /* octet of the padded message "namespace || name || padding || length" */
+    constexpr std::uint8_t digest_octet(const uuid::bytes_type &_ns, std::string_view _name,
+                                        std::size_t _i, std::size_t _blocks, bool _bigendian) noexcept {
+        std::size_t len = UUID_LEN_BIN + _name.size();
+        std::size_t end = _blocks * 64;
+        std::uint64_t bits = (std::uint64_t)len << 3;
+        if (_i < UUID_LEN_BIN)
+            return _ns[_i];
+        if (_i < len)
+            return (std::uint8_t)_name[_i - UUID_LEN_BIN];
+        if (_i == len)
+            return 0x80;
+        if (_i >= end - 8)
+            return (std::uint8_t)(bits >> (8 * (_bigendian ? (end - 1 - _i) : (_i - (end - 8)))));
+        return 0;
+    }
+
+    constexpr std::size_t digest_blocks(std::string_view _name) noexcept {
+        return (UUID_LEN_BIN + _name.size() + 8) / 64 + 1;
+    }
+
+    constexpr uuid::bytes_type md5(const uuid::bytes_type &_ns, std::string_view _name) noexcept {
+        std::uint32_t h[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+        std::uint32_t m[16] = {};
+        std::uint32_t a = 0, b = 0, c = 0, d = 0, f = 0, t = 0;
+        std::size_t blocks = digest_blocks(_name);
+        std::size_t k = 0, i = 0, g = 0;
+        uuid::bytes_type out = {};
+
+        for (k = 0; k < blocks; k++) {
+            for (i = 0; i < 16; i++)
+                m[i] =  (std::uint32_t)digest_octet(_ns, _name, k * 64 + i * 4 + 0, blocks, false)
+                     | ((std::uint32_t)digest_octet(_ns, _name, k * 64 + i * 4 + 1, blocks, false) <<  8)
+                     | ((std::uint32_t)digest_octet(_ns, _name, k * 64 + i * 4 + 2, blocks, false) << 16)
+                     | ((std::uint32_t)digest_octet(_ns, _name, k * 64 + i * 4 + 3, blocks, false) << 24);
+            a = h[0]; b = h[1]; c = h[2]; d = h[3];
+            for (i = 0; i < 64; i++) {
+                if (i < 16)      { f = (b & c) | (~b & d); g = i;               }
+                else if (i < 32) { f = (d & b) | (~d & c); g = (5 * i + 1) % 16; }
+                else if (i < 48) { f = b ^ c ^ d;          g = (3 * i + 5) % 16; }
+                else             { f = c ^ (b | ~d);       g = (7 * i) % 16;     }
+                t = d;
+                d = c;
+                c = b;
+                b = b + rotl(a + f + md5_k[i] + m[g], md5_s[(i / 16) * 4 + (i % 4)]);
+                a = t;
+            }
+            h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+        }
+        for (i = 0; i < UUID_LEN_BIN; i++)
+            out[i] = (std::uint8_t)(h[i / 4] >> (8 * (i % 4)));
+        return out;
+    }
+
+    constexpr uuid::bytes_type sha1(const uuid::bytes_type &_ns, std::string_view _name) noexcept {
+        std::uint32_t h[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+        std::uint32_t w[80] = {};
+        std::uint32_t a = 0, b = 0, c = 0, d = 0, e = 0, f = 0, t = 0;
+        std::size_t blocks = digest_blocks(_name);
+        std::size_t k = 0, i = 0;
+        uuid::bytes_type out = {};
+
+        for (k = 0; k < blocks; k++) {
+            for (i = 0; i < 16; i++)
+                w[i] = ((std::uint32_t)digest_octet(_ns, _name, k * 64 + i * 4 + 0, blocks, true) << 24)
+                     | ((std::uint32_t)digest_octet(_ns, _name, k * 64 + i * 4 + 1, blocks, true) << 16)
+                     | ((std::uint32_t)digest_octet(_ns, _name, k * 64 + i * 4 + 2, blocks, true) <<  8)
+                     |  (std::uint32_t)digest_octet(_ns, _name, k * 64 + i * 4 + 3, blocks, true);
+            for (i = 16; i < 80; i++)
+                w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+            a = h[0]; b = h[1]; c = h[2]; d = h[3]; e = h[4];
+            for (i = 0; i < 80; i++) {
+                if (i < 20)      f = ((b & c) | (~b & d))         + 0x5a827999;
+                else if (i < 40) f = (b ^ c ^ d)                  + 0x6ed9eba1;
+                else if (i < 60) f = ((b & c) | (b & d) | (c & d)) + 0x8f1bbcdc;
+                else             f = (b ^ c ^ d)                  + 0xca62c1d6;
+                t = rotl(a, 5) + f + e + w[i];
+                e = d;
+                d = c;
+                c = rotl(b, 30);
+                b = a;
+                a = t;
+            }
+            h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+        }
+        for (i = 0; i < UUID_LEN_BIN; i++)
+            out[i] = (std::uint8_t)(h[i / 4] >> (8 * (3 - (i % 4))));
+        return out;
+    }
+
+    /* brand UUID octets with version and variant (DCE 1.1) */
+    constexpr uuid brand(uuid::bytes_type _b, unsigned int _version) noexcept {
+        _b[6] = (std::uint8_t)((_b[6] & 0x0f) | (_version << 4));
+        _b[8] = (std::uint8_t)((_b[8] & 0x3f) | 0x80);
+        return uuid(_b);
+    }
+}
+
+/* name based UUIDs of version 3 (MD5) and version 5 (SHA-1),
+   computed without any C API object (usable in constant expressions) */
+constexpr uuid uuid_v3(const uuid &_ns, std::string_view _name) noexcept
+{
+    return detail::brand(detail::md5(_ns.bytes(), _name), 3);
+}
+constexpr uuid uuid_v5(const uuid &_ns, std::string_view _name) noexcept
+{
+    return detail::brand(detail::sha1(_ns.bytes(), _name), 5);
+}
+
+/* UUID generator class: owns the C API object (PRNG, MAC address,
+   time and clock sequence state) and hands out plain UUID values */
+class uuid_generator {
+    public:
+        /* construction & destruction */
+                      uuid_generator ();                       /* standard constructor */
+                      uuid_generator (uuid_generator &&_obj) noexcept; /* move constructor */
+                      uuid_generator (const uuid_generator &) = delete;
+                     ~uuid_generator ();                       /* destructor */
+
+        /* moving */
+        uuid_generator &operator=  (uuid_generator &&_obj) noexcept; /* move assignment operator */
+        uuid_generator &operator=  (const uuid_generator &) = delete;
+
+        /* content generation */
+        uuid          make         (unsigned int _mode);       /* UUID_MAKE_V1 and UUID_MAKE_V4 */
+        uuid          make         (unsigned int _mode, const uuid &_ns, const char *_name); /* UUID_MAKE_V3 and UUID_MAKE_V5 */
+
+    private:
+        uuid_t *ctx;
+        uuid_t *ns;
+};
+
+/* typed generator of time or random based UUIDs (see v1_generator,
+   v4_generator, v7_generator and ulid_generator below): callable, an endless input
+   range of fresh UUIDs and a (parallel) bulk filler */
+template <unsigned int Mode>
+class basic_generator {
+    public:
+        class sentinel {};
+        class iterator {
+            public:
+                typedef std::input_iterator_tag iterator_category;
+                typedef uuid                    value_type;
+                typedef std::ptrdiff_t          difference_type;
+                typedef const uuid             *pointer;
+                typedef const uuid             &reference;
+
+                iterator   () noexcept : gen(nullptr), cur() {}
+                explicit iterator(basic_generator *_gen) : gen(_gen), cur(_gen->make()) {}
+                reference  operator*  () const noexcept { return cur; }
+                pointer    operator-> () const noexcept { return &cur; }
+                iterator  &operator++ () { cur = gen->make(); return *this; }
+                void       operator++ (int) { ++*this; }
+                friend bool operator== (const iterator &, sentinel) noexcept { return false; }
+                friend bool operator== (sentinel, const iterator &) noexcept { return false; }
+                friend bool operator!= (const iterator &, sentinel) noexcept { return true; }
+                friend bool operator!= (sentinel, const iterator &) noexcept { return true; }
+
+            private:
+                basic_generator *gen;
+                uuid cur;
+        };
+
+        /* content generation */
+        uuid          make         (void)                 { return gen.make(Mode); }
+        uuid          operator()   (void)                 { return gen.make(Mode); }
+
+        /* endless range (generates lazily on increment) */
+        iterator      begin        (void)                 { return iterator(this); }
+        sentinel      end          (void) const noexcept  { return sentinel(); }
+
+        /* bulk generation, split across _threads threads (0 = one per core);
+           each extra thread uses a generator of its own, so for version 7
+           UUIDs and ULIDs the ordering is guaranteed within each slice only
+           (version 1 UUIDs with the real MAC address use a single thread) */
+        void          fill         (uuid *_first, uuid *_last, unsigned int _threads = 0);
+#ifdef UUIDXX_HAVE_SPAN
+        void          fill         (std::span<uuid> _out, unsigned int _threads = 0) {
+                          fill(_out.data(), _out.data() + _out.size(), _threads); }
+#endif
+
+    private:
+        static constexpr std::size_t slice_min = 65536; /* minimum UUIDs per thread */
+        uuid_generator gen;
+};
+
+template <unsigned int Mode>
+void basic_generator<Mode>::fill(uuid *_first, uuid *_last, unsigned int _threads)
+{
+    std::size_t n = (std::size_t)(_last - _first);
+    std::size_t slices, slice, i;
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors;
+
+    /* determine number of slices (version 1 UUIDs with the real MAC
+       address rely on the time and clock sequence state of a single
+       context, so they are always generated by a single thread) */
+    if ((Mode & UUID_MAKE_V1) && !(Mode & UUID_MAKE_MC))
+        _threads = 1;
+    else if (_threads == 0)
+        _threads = std::thread::hardware_concurrency();
+    slices = std::min<std::size_t>(std::max(_threads, 1U), n / slice_min);
+    if (slices <= 1) {
+        for (; _first != _last; ++_first)
+            *_first = make();
+        return;
+    }
+
+    /* generate all but the first slice in extra threads */
+    slice = (n + slices - 1) / slices;
+    errors.resize(slices);
+    workers.reserve(slices - 1);
+    for (i = 1; i < slices; i++) {
+        uuid *first = _first + i * slice;
+        uuid *last  = _first + std::min(n, (i + 1) * slice);
+        std::exception_ptr *error = &errors[i];
+        workers.emplace_back([first, last, error]() {
+            try {
+                basic_generator gen;
+                for (uuid *u = first; u != last; ++u)
+                    *u = gen.make();
+            }
+            catch (...) {
+                *error = std::current_exception();
+            }
+        });
+    }
+    try {
+        for (uuid *u = _first; u != _first + slice; ++u)
+            *u = make();
+    }
+    catch (...) {
+        errors[0] = std::current_exception();
+    }
+    for (std::thread &t : workers)
+        t.join();
+    for (std::exception_ptr &e : errors)
+        if (e)
+            std::rethrow_exception(e);
+}
+
+typedef basic_generator<UUID_MAKE_V1> v1_generator;  /* time and node based */
+typedef basic_generator<UUID_MAKE_V4> v4_generator;  /* random data based */
+typedef basic_generator<UUID_MAKE_V7> v7_generator;  /* Unix Epoch time and random data based */
+typedef basic_generator<UUID_MAKE_ULID> ulid_generator; /* monotonic ULIDs */
+
+/* typed generator of name based UUIDs within a fixed namespace */
+template <unsigned int Mode>
+class basic_name_generator {
+    public:
+        explicit      basic_name_generator (const uuid &_ns) : ns(_ns) {}
+
+        /* content generation */
+        uuid          make         (const char *_name)         { return gen.make(Mode, ns, _name); }
+        uuid          make         (const std::string &_name)  { return gen.make(Mode, ns, _name.c_str()); }
+        uuid          operator()   (const char *_name)         { return make(_name); }
+        uuid          operator()   (const std::string &_name)  { return make(_name); }
+        const uuid   &ns_uuid      (void) const noexcept       { return ns; }
+
+    private:
+        uuid ns;
+        uuid_generator gen;
+};
+
+typedef basic_name_generator<UUID_MAKE_V3> v3_generator;  /* name based, MD5 */
+typedef basic_name_generator<UUID_MAKE_V5> v5_generator;  /* name based, SHA-1 */
+
+/* sorted set of UUIDs in contiguous storage: lookups search a dense
+   array of the high 64-bit words first, which keeps the binary search
+   cache friendly, and finish with a scan of a small window (vectorized
+   only if SSE4.2 or NEON is enabled at compile-time, so a default x86-64
+   build without -msse4.2 uses the scalar loop) */
+class uuid_set {
+    public:
+        typedef uuid                                 value_type;
+        typedef std::vector<uuid>::size_type         size_type;
+        typedef std::vector<uuid>::const_iterator    const_iterator;
+        typedef const_iterator                       iterator;
+
+        /* construction */
+                      uuid_set     () = default;
+        template <class It>
+                      uuid_set     (It _first, It _last) { assign(_first, _last); }
+                      uuid_set     (std::initializer_list<uuid> _il) { assign(_il.begin(), _il.end()); }
+        template <class It>
+        void          assign       (It _first, It _last);
+
+        /* capacity */
+        size_type     size         (void) const noexcept { return items.size(); }
+        bool          empty        (void) const noexcept { return items.empty(); }
+        void          reserve      (size_type _n)        { items.reserve(_n); keys.reserve(_n); }
+        void          clear        (void) noexcept       { items.clear(); keys.clear(); }
+
+        /* iteration (in ascending order) */
+        const_iterator begin       (void) const noexcept { return items.begin(); }
+        const_iterator end         (void) const noexcept { return items.end(); }
+
+        /* lookup */
+        const_iterator lower_bound (const uuid &_u) const noexcept { return items.begin() + (std::ptrdiff_t)search(_u); }
+        const_iterator find        (const uuid &_u) const noexcept {
+                          const_iterator it = lower_bound(_u);
+                          return (it != items.end() && *it == _u) ? it : items.end(); }
+        bool          contains     (const uuid &_u) const noexcept { return find(_u) != items.end(); }
+        size_type     count        (const uuid &_u) const noexcept { return contains(_u) ? 1 : 0; }
+
+        /* modification */
+        std::pair<const_iterator, bool> insert(const uuid &_u);
+        size_type     erase        (const uuid &_u);
+
+    private:
+        static constexpr size_type scan = 16;   /* window size of the final linear scan */
+        static size_type count_less(const std::uint64_t *_k, size_type _n, std::uint64_t _w) noexcept;
+        size_type     search       (const uuid &_u) const noexcept;
+
+        std::vector<uuid> items;                /* the UUIDs in ascending order */
+        std::vector<std::uint64_t> keys;        /* high words of the UUIDs in items */
+};
+
+template <class It>
+inline void uuid_set::assign(It _first, It _last)
+{
+    items.assign(_first, _last);
+    std::sort(items.begin(), items.end());
+    items.erase(std::unique(items.begin(), items.end()), items.end());
+    keys.resize(items.size());
+    for (size_type i = 0; i < items.size(); i++)
+        keys[i] = items[i].word(0);
+}
+
+/* number of the (ascending) words _k[0.._n-1] less than _w */
+inline uuid_set::size_type uuid_set::count_less(const std::uint64_t *_k, size_type _n, std::uint64_t _w) noexcept
+{
+    size_type i = 0, cnt = 0;
+
+#if defined(__SSE4_2__)
+    /* SSE4.2 only has a signed 64-bit compare, so flip the sign bits */
+    const __m128i bias = _mm_set1_epi64x((long long)0x8000000000000000ULL);
+    const __m128i w = _mm_xor_si128(_mm_set1_epi64x((long long)_w), bias);
+    for (; i + 2 <= _n; i += 2) {
+        __m128i k = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(_k + i)), bias);
+        int m = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(w, k)));
+        cnt += (size_type)((m & 1) + (m >> 1));
+    }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    const uint64x2_t w = vdupq_n_u64(_w);
+    for (; i + 2 <= _n; i += 2) {
+        uint64x2_t m = vshrq_n_u64(vcltq_u64(vld1q_u64(_k + i), w), 63);
+        cnt += (size_type)(vgetq_lane_u64(m, 0) + vgetq_lane_u64(m, 1));
+    }
+#endif
+    for (; i < _n; i++)
+        cnt += (size_type)(_k[i] < _w);
+    return cnt;
+}
+
+/* index of the first UUID not less than _u */
+inline uuid_set::size_type uuid_set::search(const uuid &_u) const noexcept
+{
+    const std::uint64_t w0 = _u.word(0);
+    const std::uint64_t *k = keys.data();
+    size_type first = 0, n = keys.size(), half, last;
+
+    /* binary search on the high words down to a small window */
+    while (n > scan) {
+        half = n / 2;
+        if (k[first + half] < w0) {
+            first += half + 1;
+            n     -= half + 1;
+        }
+        else
+            n = half;
+    }
+
+    /* branch-free scan of the window */
+    first += count_less(k + first, n, w0);
+
+    /* resolve equal high words (e.g. of monotonic ULIDs of the same
+       millisecond) by a binary search within their run */
+    if (first < keys.size() && k[first] == w0) {
+        last  = (size_type)(std::upper_bound(k + first, k + keys.size(), w0) - k);
+        first = (size_type)(std::lower_bound(items.begin() + (std::ptrdiff_t)first,
+                                             items.begin() + (std::ptrdiff_t)last, _u) - items.begin());
+    }
+    return first;
+}
+
+inline std::pair<uuid_set::const_iterator, bool> uuid_set::insert(const uuid &_u)
+{
+    size_type i = search(_u);
+
+    if (i < items.size() && items[i] == _u)
+        return std::make_pair(items.begin() + (std::ptrdiff_t)i, false);
+    items.insert(items.begin() + (std::ptrdiff_t)i, _u);
+    keys.insert(keys.begin() + (std::ptrdiff_t)i, _u.word(0));
+    return std::make_pair(items.begin() + (std::ptrdiff_t)i, true);
+}
+
+inline uuid_set::size_type uuid_set::erase(const uuid &_u)
+{
+    size_type i = search(_u);
+
+    if (i == items.size() || items[i] != _u)
+        return 0;
+    items.erase(items.begin() + (std::ptrdiff_t)i);
+    keys.erase(keys.begin() + (std::ptrdiff_t)i);
+    return 1;
+}
+
+} /* namespace ossp */
+
+/* hashing support (for std::unordered_map and friends): the UUID octets
+   are either random, a digest or contain a fine-grained timestamp in the
+   first word, so mixing the two words is sufficient */
+namespace std {
+template <>
+struct hash<ossp::uuid> {
+    std::size_t operator()(const ossp::uuid &_u) const noexcept {
+        std::uint64_t h = _u.word(0) ^ (_u.word(1) * 0x9e3779b97f4a7c15ULL);
+        return (std::size_t)(h ^ (h >> 32));
+    }
+};
+}
+
+#endif /* value-semantic API */
+
 #endif /* __UUIDXX_HH__ */
 
@@ -0,0 +1,344 @@
+/*
+**  OSSP uuid - Universally Unique Identifier
+**  Copyright (c) 2004-2008 Ralf S. Engelschall <rse@engelschall.com>
+**  Copyright (c) 2004-2008 The OSSP Project <http://www.ossp.org/>
+**
+**  This file is part of OSSP uuid, a library for the generation
+**  of UUIDs which can found at http://www.ossp.org/pkg/lib/uuid/
+**
+**  Permission to use, copy, modify, and distribute this software for
+**  any purpose with or without fee is hereby granted, provided that
+**  the above copyright notice and this permission notice appear in all
+**  copies.
+**
+**  THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+**  WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+**  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+**  IN NO EVENT SHALL THE AUTHORS AND COPYRIGHT HOLDERS AND THEIR
+**  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+**  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+**  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+**  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+**  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+**  OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+**  SUCH DAMAGE.
+**
+**  uuid++_check.cc: self-test of the C++ value API (for "make check")
+*/
+
+/* own headers */
+#include "uuid++.hh"
+
+/* system headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef UUIDXX_HAVE_VALUE_API
+
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include <unordered_set>
+#include <vector>
+
+using namespace ossp::literals;
+
+/* number of failed checks */
+static int failed = 0;
+
+/* check a single condition */
+#define CHECK(cond) \
+    do { if (!(cond)) { \
+        fprintf(stderr, "uuid++_check:FAILED: %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        failed++; \
+    } } while (0)
+
+/* version 3 and 5 known answers (same as the uuid(1) ones of "make check") */
+static const struct {
+    const char *name;
+    const char *v3;
+    const char *v5;
+} kat[] = {
+    { "http://www.ossp.org/",
+      "02d9e6d5-9467-382e-8f9b-9300a64ac3cd", "8f4ca4fd-154e-5063-b6db-aa91af137037" },
+    { "http://www.ossp.org/pkg/lib/uuid/",
+      "ad86e3f0-b1e6-3ff8-a053-0d729351a8f3", "0bb7ccdc-c436-5489-b14a-a896627db724" },
+    { "http://www.ossp.org/pkg/lib/uuid/uuid-1.6.2.tar.gz/mirror/ftp.ossp.org/arch/source/format/tar.gz/signature/yes/release/1.6.2",
+      "31aa5682-7fd0-3b33-b289-2aa8085edc95", "65d5373d-b04b-5eca-b017-13c5dcc15635" }
+};
+
+/* the compiler has to derive the same known answers */
+static_assert(ossp::uuid_v3(ossp::ns::url, "http://www.ossp.org/")
+              == "02d9e6d5-9467-382e-8f9b-9300a64ac3cd"_uuid, "constexpr v3 UUID");
+static_assert(ossp::uuid_v5(ossp::ns::url, "http://www.ossp.org/")
+              == "8f4ca4fd-154e-5063-b6db-aa91af137037"_uuid, "constexpr v5 UUID");
+static_assert(ossp::uuid_v3(ossp::ns::url, "http://www.ossp.org/pkg/lib/uuid/uuid-1.6.2.tar.gz/mirror/ftp.ossp.org/arch/source/format/tar.gz/signature/yes/release/1.6.2")
+              == "31aa5682-7fd0-3b33-b289-2aa8085edc95"_uuid, "constexpr v3 UUID (multi-block)");
+static_assert(ossp::uuid_v5(ossp::ns::url, "http://www.ossp.org/pkg/lib/uuid/uuid-1.6.2.tar.gz/mirror/ftp.ossp.org/arch/source/format/tar.gz/signature/yes/release/1.6.2")
+              == "65d5373d-b04b-5eca-b017-13c5dcc15635"_uuid, "constexpr v5 UUID (multi-block)");
+static_assert(ossp::ns::nil.isnil() && !ossp::ns::dns.isnil(), "constexpr isnil");
+static_assert(ossp::ns::dns < ossp::ns::url && ossp::ns::url.version() == 1, "constexpr ordering");
+
+/* name based UUID through the C API */
+static ossp::uuid
+c_api_name(unsigned int mode, const char *ns, const char *name)
+{
+    uuid_t *uuid, *uuid_ns;
+    ossp::uuid u;
+
+    if (   uuid_create(&uuid) != UUID_RC_OK
+        || uuid_create(&uuid_ns) != UUID_RC_OK
+        || uuid_load(uuid_ns, ns) != UUID_RC_OK
+        || uuid_make(uuid, mode, uuid_ns, name) != UUID_RC_OK)
+        throw uuid_error_t(UUID_RC_INT);
+    u = ossp::uuid(uuid);
+    uuid_destroy(uuid_ns);
+    uuid_destroy(uuid);
+    return u;
+}
+
+/* value type, string conversion and literal */
+static void
+check_value(void)
+{
+    ossp::uuid u, v;
+    char buf[UUID_LEN_STR + 8];
+    std::to_chars_result tr;
+    std::from_chars_result fr;
+    const char *str = "f81d4fae-7dec-11d0-a765-00a0c91e6bf6";
+
+    fr = ossp::from_chars(str, str + strlen(str), u);
+    CHECK(fr.ec == std::errc() && fr.ptr == str + UUID_LEN_STR);
+    CHECK(u == "F81D4FAE-7DEC-11D0-A765-00A0C91E6BF6"_uuid);
+    CHECK(u.version() == 1 && u.word(0) == 0xf81d4fae7dec11d0ULL && u.word(1) == 0xa76500a0c91e6bf6ULL);
+    tr = ossp::to_chars(buf, buf + sizeof(buf), u);
+    CHECK(tr.ec == std::errc() && tr.ptr == buf + UUID_LEN_STR && memcmp(buf, str, UUID_LEN_STR) == 0);
+    CHECK(ossp::to_string(u) == str);
+    tr = ossp::to_chars(buf, buf + UUID_LEN_STR - 1, u);
+    CHECK(tr.ec == std::errc::value_too_large);
+    fr = ossp::from_chars("f81d4fae-7dec-11d0-a765-00a0c91e6bfx", str + UUID_LEN_STR, v);
+    CHECK(fr.ec == std::errc::invalid_argument);
+    fr = ossp::from_chars(str, str + UUID_LEN_STR - 1, v);
+    CHECK(fr.ec == std::errc::invalid_argument);
+    CHECK(ossp::uuid::from_bytes(u.data()) == u);
+    v = u;
+    CHECK(v == u && !(v < u) && v <= u && v >= u && !(v != u));
+    CHECK(ossp::ns::nil < u && u > ossp::ns::nil);
+    CHECK(std::hash<ossp::uuid>()(u) == std::hash<ossp::uuid>()(v));
+    CHECK(std::hash<ossp::uuid>()(u) != std::hash<ossp::uuid>()(ossp::ns::dns));
+}
+
+/* name based generation: constexpr, C++ generators and C API agree */
+static void
+check_names(void)
+{
+    ossp::v3_generator g3(ossp::ns::url);
+    ossp::v5_generator g5(ossp::ns::url);
+    ossp::uuid expect3, expect5;
+    size_t i;
+
+    for (i = 0; i < sizeof(kat) / sizeof(kat[0]); i++) {
+        (void)ossp::from_chars(kat[i].v3, kat[i].v3 + UUID_LEN_STR, expect3);
+        (void)ossp::from_chars(kat[i].v5, kat[i].v5 + UUID_LEN_STR, expect5);
+        CHECK(ossp::uuid_v3(ossp::ns::url, kat[i].name) == expect3);
+        CHECK(ossp::uuid_v5(ossp::ns::url, kat[i].name) == expect5);
+        CHECK(g3(kat[i].name) == expect3);
+        CHECK(g5(std::string(kat[i].name)) == expect5);
+        CHECK(c_api_name(UUID_MAKE_V3, "ns:URL", kat[i].name) == expect3);
+        CHECK(c_api_name(UUID_MAKE_V5, "ns:URL", kat[i].name) == expect5);
+    }
+    /* names around the MD5/SHA-1 block boundaries */
+    for (i = 0; i < 140; i++) {
+        std::string name(i, 'x');
+        CHECK(ossp::uuid_v3(ossp::ns::dns, name) == c_api_name(UUID_MAKE_V3, "ns:DNS", name.c_str()));
+        CHECK(ossp::uuid_v5(ossp::ns::dns, name) == c_api_name(UUID_MAKE_V5, "ns:DNS", name.c_str()));
+    }
+}
+
+/* time and random based generation, lazy range and bulk fill */
+static void
+check_generators(void)
+{
+    ossp::uuid_generator gen;
+    ossp::v7_generator g7;
+    ossp::v4_generator g4;
+    ossp::v1_generator g1;
+    std::vector<ossp::uuid> out(300000);
+    std::unordered_set<ossp::uuid> seen;
+    ossp::uuid prev;
+    int n;
+
+    CHECK(gen.make(UUID_MAKE_V1).version() == 1);
+    CHECK(gen.make(UUID_MAKE_V4).version() == 4);
+    CHECK(gen.make(UUID_MAKE_V7).version() == 7);
+    n = 0;
+    for (const ossp::uuid &u : g7) {
+        CHECK(u.version() == 7 && (n == 0 || prev < u));
+        prev = u;
+        if (++n == 1000)
+            break;
+    }
+
+    /* bulk fill with several threads (slices of at least 65536 UUIDs) */
+    g4.fill(out.data(), out.data() + out.size(), 4);
+    seen.insert(out.begin(), out.end());
+    CHECK(seen.size() == out.size());
+    CHECK(out.front().version() == 4 && out.back().version() == 4);
+    g7.fill(out.data(), out.data() + out.size(), 4);
+    seen.clear();
+    seen.insert(out.begin(), out.end());
+    CHECK(seen.size() == out.size());
+    g1.fill(out.data(), out.data() + out.size(), 4);
+    seen.clear();
+    seen.insert(out.begin(), out.end());
+    CHECK(seen.size() == out.size());
+}
+
+/* sorted flat set against std::set */
+static void
+check_set(void)
+{
+    ossp::v4_generator g4;
+    ossp::uuid_set set;
+    std::set<ossp::uuid> ref;
+    std::vector<ossp::uuid> keys, probes;
+    std::chrono::steady_clock::time_point t0;
+    double t_set, t_ref;
+    size_t i, hits;
+    ossp::uuid::bytes_type b;
+
+    /* random keys plus a run with equal high words */
+    for (i = 0; i < 20000; i++)
+        keys.push_back(g4());
+    b = ossp::ns::dns.bytes();
+    for (i = 0; i < 100; i++) {
+        b[15] = (std::uint8_t)(i * 2);
+        keys.push_back(ossp::uuid(b));
+    }
+    keys.push_back(keys[0]);
+    set.assign(keys.begin(), keys.end());
+    ref.insert(keys.begin(), keys.end());
+    CHECK(set.size() == ref.size());
+    CHECK(std::equal(set.begin(), set.end(), ref.begin(), ref.end()));
+
+    /* lookups of members and non-members */
+    probes.assign(keys.begin(), keys.end());
+    for (i = 0; i < 20000; i++)
+        probes.push_back(g4());
+    for (i = 0; i < 201; i++) {
+        b[15] = (std::uint8_t)i;
+        probes.push_back(ossp::uuid(b));
+    }
+    probes.push_back(ossp::ns::nil);
+    probes.push_back("ffffffff-ffff-ffff-ffff-ffffffffffff"_uuid);
+    for (const ossp::uuid &p : probes) {
+        ossp::uuid_set::const_iterator it = set.lower_bound(p);
+        std::set<ossp::uuid>::const_iterator rt = ref.lower_bound(p);
+        CHECK((it == set.end()) == (rt == ref.end()));
+        if (it != set.end() && rt != ref.end())
+            CHECK(*it == *rt);
+        CHECK(set.count(p) == ref.count(p));
+    }
+
+    /* insertion and erasure */
+    for (i = 0; i < 201; i++) {
+        b[15] = (std::uint8_t)i;
+        CHECK(set.insert(ossp::uuid(b)).second == ref.insert(ossp::uuid(b)).second);
+    }
+    for (i = 0; i < keys.size(); i += 3)
+        CHECK(set.erase(keys[i]) == ref.erase(keys[i]));
+    CHECK(set.size() == ref.size());
+    CHECK(std::equal(set.begin(), set.end(), ref.begin(), ref.end()));
+
+    /* lookup speed (informational only) */
+    t0 = std::chrono::steady_clock::now();
+    for (hits = 0, i = 0; i < 20; i++)
+        for (const ossp::uuid &p : probes)
+            hits += set.count(p);
+    t_set = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    t0 = std::chrono::steady_clock::now();
+    for (i = 0; i < 20; i++)
+        for (const ossp::uuid &p : probes)
+            hits -= ref.count(p);
+    t_ref = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    CHECK(hits == 0);
+    fprintf(stdout, "uuid_set lookup: %.1f ns/op (std::set: %.1f ns/op)\n",
+            t_set / (20.0 * (double)probes.size()), t_ref / (20.0 * (double)probes.size()));
+}
+
+/* sorted flat set with long runs of equal high words */
+static void
+check_set_runs(void)
+{
+    ossp::ulid_generator gu;
+    ossp::uuid_set set;
+    std::set<ossp::uuid> ref;
+    std::vector<ossp::uuid> keys;
+    ossp::uuid::bytes_type b;
+    std::size_t i;
+    int j;
+
+    /* one run of 50000 UUIDs sharing the high word (even low words) */
+    b = ossp::ns::url.bytes();
+    for (i = 0; i < 50000; i++) {
+        for (j = 0; j < 8; j++)
+            b[15 - j] = (std::uint8_t)(((std::uint64_t)i * 2) >> (8 * j));
+        keys.push_back(ossp::uuid(b));
+    }
+    /* monotonic ULIDs (mostly of the same millisecond) */
+    for (i = 0; i < 20000; i++)
+        keys.push_back(gu());
+    set.assign(keys.begin(), keys.end());
+    ref.insert(keys.begin(), keys.end());
+    CHECK(set.size() == ref.size());
+    for (const ossp::uuid &u : keys)
+        CHECK(set.find(u) != set.end() && *set.find(u) == u);
+
+    /* the odd low words in between are no members */
+    b = ossp::ns::url.bytes();
+    for (i = 0; i < 50000; i += 7) {
+        for (j = 0; j < 8; j++)
+            b[15 - j] = (std::uint8_t)(((std::uint64_t)i * 2 + 1) >> (8 * j));
+        CHECK(set.count(ossp::uuid(b)) == 0);
+        CHECK(*set.lower_bound(ossp::uuid(b)) == *ref.lower_bound(ossp::uuid(b)));
+        CHECK(set.insert(ossp::uuid(b)).second && ref.insert(ossp::uuid(b)).second);
+    }
+    CHECK(std::equal(set.begin(), set.end(), ref.begin(), ref.end()));
+}
+
+/* main procedure */
+int
+main(void)
+{
+    try {
+        check_value();
+        check_names();
+        check_generators();
+        check_set();
+        check_set_runs();
+    }
+    catch (uuid_error_t &e) {
+        fprintf(stderr, "uuid++_check:ERROR: %s\n", e.string());
+        return 1;
+    }
+    if (failed > 0) {
+        fprintf(stderr, "uuid++_check: %d check(s) FAILED\n", failed);
+        return 1;
+    }
+    fprintf(stdout, "C++ value API: OK\n");
+    return 0;
+}
+
+#else /* UUIDXX_HAVE_VALUE_API */
+
+/* main procedure */
+int
+main(void)
+{
+    fprintf(stdout, "C++ value API: skipped (requires ISO C++17)\n");
+    return 0;
+}
+
+#endif /* UUIDXX_HAVE_VALUE_API */
@@ -62,6 +62,7 @@
 #include "uuid_ui128.h"
 #include "uuid_str.h"
 #include "uuid_bm.h"
+#include "uuid_usdt.h"
 #include "uuid_ac.h"
 
 /* maximum number of 100ns ticks of the actual resolution of system clock
@@ -72,6 +73,7 @@
    (UUID UTC base time is October 15, 1582
     Unix UTC base time is January  1, 1970) */
 #define UUID_TIMEOFFSET "01B21DD213814000"
+#define UUID_TIMEOFFSET_TICKS UINT64_C(0x01B21DD213814000)
 
 /* IEEE 802 MAC address encoding/decoding bit fields */
 #define IEEE_MAC_MCBIT BM_OCTET(0,0,0,0,0,0,0,1)
@@ -80,6 +82,20 @@
 /* IEEE 802 MAC address octet length */
 #define IEEE_MAC_OCTETS 6
 
+/* number of uuid_make() calls after which the event counters of
+   an object are folded into the process-wide statistics */
+#define UUID_STATS_BATCH 256
+
+/* atomic addition for the process-wide statistics */
+#if defined(__GNUC__)
+#define UUID_STATS_ADD(var, n) (void)__sync_fetch_and_add(&(var), (n))
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define UUID_STATS_ADD(var, n) (void)_InterlockedExchangeAdd((volatile long *)&(var), (long)(n))
+#else
+#define UUID_STATS_ADD(var, n) ((var) += (n))
+#endif
+
 /* UUID binary representation according to UUID standards */
 typedef struct {
     uuid_uint32_t  time_low;                  /* bits  0-31 of time field */
@@ -99,8 +115,47 @@ struct uuid_st {
     uuid_uint8_t   mac[IEEE_MAC_OCTETS];      /* pre-determined MAC address */
     struct timeval time_last;                 /* last retrieved timestamp */
     unsigned long  time_seq;                  /* last timestamp sequence counter */
+    ui64_t         time_v7;                   /* last version 7 timestamp (1/4096 msec) */
+    ui64_t         time_ulid;                 /* last ULID timestamp (msec) */
+    uuid_uint8_t   rand_ulid[10];             /* last ULID random part */
+    uuid_stats_t   stats;                     /* event counters not yet folded */
+    int            stats_urgent;              /* rare event: fold immediately */
 };
 
+/* process-wide statistics (of all destroyed and folded objects) */
+static volatile uuid_stats_t uuid_stats_all;
+
+/* INTERNAL: fold the event counters of an object into the process-wide statistics */
+static void uuid_stats_fold(uuid_t *uuid)
+{
+    prng_stats_t ps;
+
+    if (prng_stats(uuid->prng, &ps) == PRNG_RC_OK) {
+        uuid->stats.prng_dev_reads      += ps.dev_reads;
+        uuid->stats.prng_dev_bytes      += ps.dev_bytes;
+        uuid->stats.prng_dev_errors     += ps.dev_errors;
+        uuid->stats.prng_fallbacks      += ps.fallbacks;
+        uuid->stats.prng_fallback_bytes += ps.fallback_bytes;
+    }
+#define FOLD(field) \
+    if (uuid->stats.field != 0) \
+        UUID_STATS_ADD(uuid_stats_all.field, uuid->stats.field)
+    FOLD(make);
+    FOLD(v1_stalls);
+    FOLD(v1_backsteps);
+    FOLD(v7_clamps);
+    FOLD(ulid_increments);
+    FOLD(prng_dev_reads);
+    FOLD(prng_dev_bytes);
+    FOLD(prng_dev_errors);
+    FOLD(prng_fallbacks);
+    FOLD(prng_fallback_bytes);
+#undef FOLD
+    memset(&uuid->stats, 0, sizeof(uuid->stats));
+    uuid->stats_urgent = 0;
+    return;
+}
+
 /* create UUID object */
 uuid_rc_t uuid_create(uuid_t **uuid)
 {
@@ -150,6 +205,12 @@ uuid_rc_t uuid_create(uuid_t **uuid)
     obj->time_last.tv_sec  = 0;
     obj->time_last.tv_usec = 0;
     obj->time_seq = 0;
+    obj->time_v7 = ui64_zero();
+    obj->time_ulid = ui64_zero();
+
+    /* initialize event counters */
+    memset(&obj->stats, 0, sizeof(obj->stats));
+    obj->stats_urgent = 0;
 
     /* store result object */
     *uuid = obj;
@@ -164,6 +225,9 @@ uuid_rc_t uuid_destroy(uuid_t *uuid)
     if (uuid == NULL)
         return UUID_RC_ARG;
 
+    /* keep the event counters in the process-wide statistics */
+    uuid_stats_fold(uuid);
+
     /* destroy PRNG, MD5 and SHA-1 sub-objects */
     (void)prng_destroy(uuid->prng);
     (void)md5_destroy(uuid->md5);
@@ -208,6 +272,15 @@ uuid_rc_t uuid_clone(const uuid_t *uuid, uuid_t **clone)
         return UUID_RC_INT;
     }
 
+    /* the clone starts with its own event counters */
+    memset(&obj->stats, 0, sizeof(obj->stats));
+    obj->stats_urgent = 0;
+
+    /* the clone draws its own ULID random part (instead of
+       incrementing the same one as the original object) */
+    obj->time_ulid = ui64_zero();
+    memset(obj->rand_ulid, 0, sizeof(obj->rand_ulid));
+
     /* store result object */
     *clone = obj;
 
@@ -621,6 +694,316 @@ static uuid_rc_t uuid_export_siv(const uuid_t *uuid, void *_data_ptr, size_t *da
     return UUID_RC_OK;
 }
 
+/*
+ *  Compact text representations (base64url, Crockford base32, base58)
+ */
+
+/* encoding alphabets (base32 and base58 ones are in ASCII order) */
+static const char uuid_b64_enc[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+static const char uuid_b32_enc[] =
+    "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+static const char uuid_b58_enc[] =
+    "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+/* decoding tables (US-ASCII only, -1 for invalid characters;
+   base32 also accepts lower case and "O", "I" and "L" look-alikes) */
+static const signed char uuid_b64_dec[128] = {
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,62,-1,-1,
+    52,53,54,55,56,57,58,59,60,61,-1,-1,-1,-1,-1,-1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,
+    15,16,17,18,19,20,21,22,23,24,25,-1,-1,-1,-1,63,
+    -1,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,
+    41,42,43,44,45,46,47,48,49,50,51,-1,-1,-1,-1,-1
+};
+static const signed char uuid_b32_dec[128] = {
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+     0, 1, 2, 3, 4, 5, 6, 7, 8, 9,-1,-1,-1,-1,-1,-1,
+    -1,10,11,12,13,14,15,16,17, 1,18,19, 1,20,21, 0,
+    22,23,24,25,26,-1,27,28,29,30,31,-1,-1,-1,-1,-1,
+    -1,10,11,12,13,14,15,16,17, 1,18,19, 1,20,21, 0,
+    22,23,24,25,26,-1,27,28,29,30,31,-1,-1,-1,-1,-1
+};
+static const signed char uuid_b58_dec[128] = {
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8,-1,-1,-1,-1,-1,-1,
+    -1, 9,10,11,12,13,14,15,16,-1,17,18,19,20,21,-1,
+    22,23,24,25,26,27,28,29,30,31,32,-1,-1,-1,-1,-1,
+    -1,33,34,35,36,37,38,39,40,41,42,43,-1,44,45,46,
+    47,48,49,50,51,52,53,54,55,56,57,-1,-1,-1,-1,-1
+};
+
+/* INTERNAL: decode a character through a decoding table */
+#define UUID_DEC(tab,c) \
+    ((unsigned char)(c) < 128 ? (int)(tab)[(unsigned char)(c)] : -1)
+
+/* INTERNAL: encode octets into base64url (RFC 4648, without padding) */
+static void uuid_enc_b64(const uuid_uint8_t *bin, char *out)
+{
+    uuid_uint32_t v;
+    int i;
+
+    for (i = 0; i < 15; i += 3) {
+        v = ((uuid_uint32_t)bin[i] << 16) | ((uuid_uint32_t)bin[i+1] << 8) | bin[i+2];
+        *out++ = uuid_b64_enc[(v >> 18) & 0x3f];
+        *out++ = uuid_b64_enc[(v >> 12) & 0x3f];
+        *out++ = uuid_b64_enc[(v >>  6) & 0x3f];
+        *out++ = uuid_b64_enc[ v        & 0x3f];
+    }
+    *out++ = uuid_b64_enc[bin[15] >> 2];
+    *out   = uuid_b64_enc[(bin[15] & 0x03) << 4];
+    return;
+}
+
+/* INTERNAL: decode base64url into octets */
+static int uuid_dec_b64(const char *in, uuid_uint8_t *bin)
+{
+    int c[UUID_LEN_B64];
+    int i;
+
+    for (i = 0; i < UUID_LEN_B64; i++)
+        if ((c[i] = UUID_DEC(uuid_b64_dec, in[i])) < 0)
+            return UUID_FALSE;
+    if (c[21] & 0x0f)
+        return UUID_FALSE; /* non-canonical trailing bits */
+    for (i = 0; i < 5; i++) {
+        bin[3*i]   = (uuid_uint8_t)((c[4*i]   << 2) | (c[4*i+1] >> 4));
+        bin[3*i+1] = (uuid_uint8_t)((c[4*i+1] << 4) | (c[4*i+2] >> 2));
+        bin[3*i+2] = (uuid_uint8_t)((c[4*i+2] << 6) |  c[4*i+3]);
+    }
+    bin[15] = (uuid_uint8_t)((c[20] << 2) | (c[21] >> 4));
+    return UUID_TRUE;
+}
+
+/* INTERNAL: encode octets into Crockford base32
+   (the 128 bit value left-padded to 130 bit, as in ULIDs) */
+static void uuid_enc_b32(const uuid_uint8_t *bin, char *out)
+{
+    uint64_t hi, lo;
+    int i, s;
+
+    hi = 0;
+    lo = 0;
+    for (i = 0; i < 8; i++) {
+        hi = (hi << 8) | bin[i];
+        lo = (lo << 8) | bin[i+8];
+    }
+    for (i = 0, s = 125; i < UUID_LEN_B32; i++, s -= 5) {
+        if (s >= 64)
+            out[i] = uuid_b32_enc[(hi >> (s - 64)) & 0x1f];
+        else if (s > 59)
+            out[i] = uuid_b32_enc[((hi << (64 - s)) | (lo >> s)) & 0x1f];
+        else
+            out[i] = uuid_b32_enc[(lo >> s) & 0x1f];
+    }
+    return;
+}
+
+/* INTERNAL: decode Crockford base32 into octets */
+static int uuid_dec_b32(const char *in, uuid_uint8_t *bin)
+{
+    uint64_t hi, lo;
+    int c;
+    int i;
+
+    hi = 0;
+    lo = 0;
+    for (i = 0; i < UUID_LEN_B32; i++) {
+        if ((c = UUID_DEC(uuid_b32_dec, in[i])) < 0)
+            return UUID_FALSE;
+        if (i == 0 && c > 7)
+            return UUID_FALSE; /* exceeds 128 bit */
+        hi = (hi << 5) | (lo >> 59);
+        lo = (lo << 5) | (uint64_t)c;
+    }
+    for (i = 7; i >= 0; i--) {
+        bin[i]   = (uuid_uint8_t)(hi & 0xff); hi >>= 8;
+        bin[i+8] = (uuid_uint8_t)(lo & 0xff); lo >>= 8;
+    }
+    return UUID_TRUE;
+}
+
+/* INTERNAL: encode octets into base58 (Bitcoin alphabet, fixed
+   width by left-padding with the zero digit "1") */
+static void uuid_enc_b58(const uuid_uint8_t *bin, char *out)
+{
+    uuid_uint32_t n[4];
+    uuid_uint32_t r;
+    uint64_t t;
+    char digits[25];
+    int i, j, k;
+
+    /* 128 bit value as four 32 bit limbs (most significant first) */
+    for (i = 0; i < 4; i++)
+        n[i] = ((uuid_uint32_t)bin[4*i] << 24) | ((uuid_uint32_t)bin[4*i+1] << 16)
+             | ((uuid_uint32_t)bin[4*i+2] << 8) | bin[4*i+3];
+
+    /* produce five digits at a time by dividing by 58^5 */
+    for (k = 25; k > 0; k -= 5) {
+        r = 0;
+        for (i = 0; i < 4; i++) {
+            t = ((uint64_t)r << 32) | n[i];
+            n[i] = (uuid_uint32_t)(t / 656356768UL);
+            r    = (uuid_uint32_t)(t % 656356768UL);
+        }
+        for (j = k - 1; j >= k - 5; j--) {
+            digits[j] = uuid_b58_enc[r % 58];
+            r /= 58;
+        }
+    }
+
+    /* 58^22 > 2^128, hence the three leading digits are always zero */
+    memcpy(out, digits + 3, UUID_LEN_B58);
+    return;
+}
+
+/* INTERNAL: decode base58 into octets */
+static int uuid_dec_b58(const char *in, uuid_uint8_t *bin)
+{
+    uuid_uint32_t n[4];
+    uuid_uint32_t m, v;
+    uint64_t t;
+    int c;
+    int i, j, k;
+
+    n[0] = n[1] = n[2] = n[3] = 0;
+    for (k = 0; k < UUID_LEN_B58; k += j) {
+        /* gather up to five digits (two first, as 22 = 2 + 4*5) */
+        j = (k == 0 ? 2 : 5);
+        m = 1;
+        v = 0;
+        for (i = k; i < k + j; i++) {
+            if ((c = UUID_DEC(uuid_b58_dec, in[i])) < 0)
+                return UUID_FALSE;
+            v = v * 58 + (uuid_uint32_t)c;
+            m *= 58;
+        }
+
+        /* n = n * 58^j + v */
+        t = v;
+        for (i = 3; i >= 0; i--) {
+            t += (uint64_t)n[i] * m;
+            n[i] = (uuid_uint32_t)(t & 0xffffffffUL);
+            t >>= 32;
+        }
+        if (t != 0)
+            return UUID_FALSE; /* exceeds 128 bit */
+    }
+    for (i = 0; i < 4; i++) {
+        bin[4*i]   = (uuid_uint8_t)(n[i] >> 24);
+        bin[4*i+1] = (uuid_uint8_t)(n[i] >> 16);
+        bin[4*i+2] = (uuid_uint8_t)(n[i] >>  8);
+        bin[4*i+3] = (uuid_uint8_t)(n[i]      );
+    }
+    return UUID_TRUE;
+}
+
+/* INTERNAL: length of compact text representations */
+static size_t uuid_enc_len(uuid_fmt_t fmt)
+{
+    switch (fmt) {
+        case UUID_FMT_B64: return UUID_LEN_B64;
+        case UUID_FMT_B32: return UUID_LEN_B32;
+        case UUID_FMT_B58: return UUID_LEN_B58;
+        case UUID_FMT_ULID: return UUID_LEN_ULID;
+        default:           return 0;
+    }
+}
+
+/* INTERNAL: import UUID object from compact text representation */
+static uuid_rc_t uuid_import_enc(uuid_t *uuid, uuid_fmt_t fmt, const void *data_ptr, size_t data_len)
+{
+    uuid_uint8_t tmp_bin[UUID_LEN_BIN];
+    const char *str;
+    int ok;
+
+    /* sanity check argument(s) */
+    if (uuid == NULL || data_ptr == NULL || data_len < uuid_enc_len(fmt))
+        return UUID_RC_ARG;
+
+    /* decode into UUID binary representation */
+    str = (const char *)data_ptr;
+    switch (fmt) {
+        case UUID_FMT_B64: ok = uuid_dec_b64(str, tmp_bin); break;
+        case UUID_FMT_B32:
+        case UUID_FMT_ULID: ok = uuid_dec_b32(str, tmp_bin); break;
+        case UUID_FMT_B58: ok = uuid_dec_b58(str, tmp_bin); break;
+        default:           ok = UUID_FALSE;                 break;
+    }
+    if (!ok)
+        return UUID_RC_ARG;
+
+    /* import into internal UUID representation */
+    return uuid_import_bin(uuid, tmp_bin, UUID_LEN_BIN);
+}
+
+/* INTERNAL: export UUID object to compact text representation */
+static uuid_rc_t uuid_export_enc(const uuid_t *uuid, uuid_fmt_t fmt, void *_data_ptr, size_t *data_len)
+{
+    char **data_ptr;
+    char *data_buf;
+    uuid_uint8_t tmp_bin[UUID_LEN_BIN];
+    void *tmp_ptr;
+    size_t tmp_len;
+    size_t len;
+    uuid_rc_t rc;
+
+    /* cast generic data pointer to particular pointer to pointer type */
+    data_ptr = (char **)_data_ptr;
+
+    /* sanity check argument(s) */
+    if (uuid == NULL || data_ptr == NULL)
+        return UUID_RC_ARG;
+
+    /* determine output buffer */
+    len = uuid_enc_len(fmt);
+    if (*data_ptr == NULL) {
+        if ((data_buf = (char *)malloc(len+1)) == NULL)
+            return UUID_RC_MEM;
+        if (data_len != NULL)
+            *data_len = len+1;
+    }
+    else {
+        data_buf = (char *)(*data_ptr);
+        if (data_len == NULL)
+            return UUID_RC_ARG;
+        if (*data_len < len+1)
+            return UUID_RC_MEM;
+        *data_len = len+1;
+    }
+
+    /* export into UUID binary representation */
+    tmp_ptr = (void *)&tmp_bin;
+    tmp_len = sizeof(tmp_bin);
+    if ((rc = uuid_export_bin(uuid, &tmp_ptr, &tmp_len)) != UUID_RC_OK) {
+        if (*data_ptr == NULL)
+            free(data_buf);
+        return rc;
+    }
+
+    /* encode into compact text representation */
+    switch (fmt) {
+        case UUID_FMT_B64: uuid_enc_b64(tmp_bin, data_buf); break;
+        case UUID_FMT_B32:
+        case UUID_FMT_ULID: uuid_enc_b32(tmp_bin, data_buf); break;
+        case UUID_FMT_B58: uuid_enc_b58(tmp_bin, data_buf); break;
+        default:           break;
+    }
+    data_buf[len] = '\0';
+
+    /* pass back new buffer if locally allocated */
+    if (*data_ptr == NULL)
+        *data_ptr = data_buf;
+
+    return UUID_RC_OK;
+}
+
 /* decoding tables */
 static struct {
     uuid_uint8_t num;
@@ -638,7 +1021,8 @@ static struct {
     { 1, "time and node based" },
     { 3, "name based, MD5" },
     { 4, "random data based" },
-    { 5, "name based, SHA-1" }
+    { 5, "name based, SHA-1" },
+    { 7, "Unix Epoch time and random data based" }
 };
 
 /* INTERNAL: dump UUID object as descriptive text */
@@ -769,6 +1153,31 @@ static uuid_rc_t uuid_export_txt(const uuid_t *uuid, void *_data_ptr, size_t *da
             (uuid->obj.node[0] & IEEE_MAC_LOBIT ? "local" : "global"),
             (uuid->obj.node[0] & IEEE_MAC_MCBIT ? "multicast" : "unicast"));
     }
+    else if (tmp8 == BM_OCTET(1,0,0,0,0,0,0,0) && tmp16 == 7) {
+        /* decode RFC 9562 version 7 UUID */
+
+        /* decode system time (48 bit milliseconds since Unix Epoch) */
+        t = ui64_rol(ui64_n2i((unsigned long)(uuid->obj.time_low)), 16, NULL);
+        t = ui64_or(t, ui64_n2i((unsigned long)(uuid->obj.time_mid)));
+        t = ui64_divn(t, 1000, &t_usec);
+        t_sec = (time_t)ui64_i2n(t);
+        tm = gmtime(&t_sec);
+        (void)strftime(t_buf, sizeof(t_buf), "%Y-%m-%d %H:%M:%S", tm);
+        (void)str_rsprintf(out, "        content: time:  %s.%03d UTC\n", t_buf, t_usec);
+
+        /* decode sub-millisecond fraction and random part */
+        (void)str_rsprintf(out, "                 fraction: %d/4096 msec\n",
+            (int)(uuid->obj.time_hi_and_version & BM_MASK(11,0)));
+        (void)str_rsprintf(out, "                 random: %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x (62 bit)\n",
+            (unsigned int)(uuid->obj.clock_seq_hi_and_reserved & BM_MASK(5,0)),
+            (unsigned int)uuid->obj.clock_seq_low,
+            (unsigned int)uuid->obj.node[0],
+            (unsigned int)uuid->obj.node[1],
+            (unsigned int)uuid->obj.node[2],
+            (unsigned int)uuid->obj.node[3],
+            (unsigned int)uuid->obj.node[4],
+            (unsigned int)uuid->obj.node[5]);
+    }
     else {
         /* decode anything else as hexadecimal byte-string only */
 
@@ -813,11 +1222,12 @@ static uuid_rc_t uuid_export_txt(const uuid_t *uuid, void *_data_ptr, size_t *da
             *data_len = out_len;
     }
     else {
-        if (data_len == NULL)
-            return UUID_RC_ARG;
-        if (*data_len < out_len)
-            return UUID_RC_MEM;
+        if (data_len == NULL || *data_len < out_len) {
+            free(out_ptr);
+            return (data_len == NULL ? UUID_RC_ARG : UUID_RC_MEM);
+        }
         memcpy(*data_ptr, out_ptr, out_len);
+        free(out_ptr);
     }
 
     return UUID_RC_OK;
@@ -837,6 +1247,10 @@ uuid_rc_t uuid_import(uuid_t *uuid, uuid_fmt_t fmt, const void *data_ptr, size_t
         case UUID_FMT_BIN: rc = uuid_import_bin(uuid, data_ptr, data_len); break;
         case UUID_FMT_STR: rc = uuid_import_str(uuid, data_ptr, data_len); break;
         case UUID_FMT_SIV: rc = uuid_import_siv(uuid, data_ptr, data_len); break;
+        case UUID_FMT_B64:
+        case UUID_FMT_B32:
+        case UUID_FMT_B58:
+        case UUID_FMT_ULID: rc = uuid_import_enc(uuid, fmt, data_ptr, data_len); break;
         case UUID_FMT_TXT: rc = UUID_RC_IMP; /* not implemented */ break;
         default:           rc = UUID_RC_ARG;
     }
@@ -859,12 +1273,142 @@ uuid_rc_t uuid_export(const uuid_t *uuid, uuid_fmt_t fmt, void *data_ptr, size_t
         case UUID_FMT_STR: rc = uuid_export_str(uuid, data_ptr, data_len); break;
         case UUID_FMT_SIV: rc = uuid_export_siv(uuid, data_ptr, data_len); break;
         case UUID_FMT_TXT: rc = uuid_export_txt(uuid, data_ptr, data_len); break;
+        case UUID_FMT_B64:
+        case UUID_FMT_B32:
+        case UUID_FMT_B58:
+        case UUID_FMT_ULID: rc = uuid_export_enc(uuid, fmt, data_ptr, data_len); break;
         default:           rc = UUID_RC_ARG;
     }
 
     return rc;
 }
 
+/* INTERNAL: decode UUID fields from binary representation */
+static void uuid_decode_octets(const uuid_uint8_t *bin, uuid_fields_t *fields)
+{
+    uint64_t t;
+    int64_t d;
+    int isnil;
+    int i;
+
+    /* determine variant and (for DCE 1.1 variant only) version */
+    if ((bin[8] & BM_OCTET(1,0,0,0,0,0,0,0)) == 0)
+        fields->variant = UUID_VARIANT_NCS;
+    else if ((bin[8] & BM_OCTET(1,1,0,0,0,0,0,0)) == BM_OCTET(1,0,0,0,0,0,0,0))
+        fields->variant = UUID_VARIANT_DCE;
+    else if ((bin[8] & BM_OCTET(1,1,1,0,0,0,0,0)) == BM_OCTET(1,1,0,0,0,0,0,0))
+        fields->variant = UUID_VARIANT_MS;
+    else
+        fields->variant = UUID_VARIANT_FUTURE;
+    fields->version = (fields->variant == UUID_VARIANT_DCE ? (unsigned int)(bin[6] >> 4) : 0);
+    fields->flags = 0;
+    fields->time = 0;
+    fields->time_unix = 0;
+    fields->clock_seq = 0;
+    memset(fields->node, 0, sizeof(fields->node));
+
+    /* check for special case of "Nil UUID" */
+    isnil = 1;
+    for (i = 0; i < UUID_LEN_BIN; i++) {
+        if (bin[i] != 0) {
+            isnil = 0;
+            break;
+        }
+    }
+    if (isnil) {
+        fields->flags |= UUID_DEC_NIL;
+        return;
+    }
+
+    /* decode time (and for version 1/6 clock sequence and node) */
+    switch (fields->version) {
+        case 1:
+        case 6:
+            /* 60 bit count of 100ns ticks since 1582-10-15 */
+            if (fields->version == 1)
+                t =   ((uint64_t)(bin[6] & 0x0f) << 56) | ((uint64_t)bin[7] << 48)
+                    | ((uint64_t)bin[4] << 40) | ((uint64_t)bin[5] << 32)
+                    | ((uint64_t)bin[0] << 24) | ((uint64_t)bin[1] << 16)
+                    | ((uint64_t)bin[2] <<  8) |  (uint64_t)bin[3];
+            else
+                t =   ((uint64_t)bin[0] << 52) | ((uint64_t)bin[1] << 44)
+                    | ((uint64_t)bin[2] << 36) | ((uint64_t)bin[3] << 28)
+                    | ((uint64_t)bin[4] << 20) | ((uint64_t)bin[5] << 12)
+                    | ((uint64_t)(bin[6] & 0x0f) << 8) | (uint64_t)bin[7];
+            fields->time = t;
+            d = (int64_t)t - (int64_t)UUID_TIMEOFFSET_TICKS;
+            if (d > INT64_MAX / 100)
+                fields->time_unix = INT64_MAX; /* saturate beyond year 2262 */
+            else if (d < INT64_MIN / 100)
+                fields->time_unix = INT64_MIN; /* saturate before year 1677 */
+            else
+                fields->time_unix = d * 100;
+            fields->flags |= UUID_DEC_TIME;
+
+            /* clock sequence and node */
+            fields->clock_seq = ((unsigned int)(bin[8] & BM_MASK(5,0)) << 8) | bin[9];
+            memcpy(fields->node, bin+10, sizeof(fields->node));
+            if (bin[10] & IEEE_MAC_LOBIT)
+                fields->flags |= UUID_DEC_LOCAL;
+            if (bin[10] & IEEE_MAC_MCBIT)
+                fields->flags |= UUID_DEC_MULTICAST;
+            fields->flags |= UUID_DEC_NODE;
+            break;
+        case 7:
+            /* 48 bit count of milliseconds since 1970-01-01 */
+            t =   ((uint64_t)bin[0] << 40) | ((uint64_t)bin[1] << 32)
+                | ((uint64_t)bin[2] << 24) | ((uint64_t)bin[3] << 16)
+                | ((uint64_t)bin[4] <<  8) |  (uint64_t)bin[5];
+            if (t > (uint64_t)(INT64_MAX / 1000000))
+                fields->time_unix = INT64_MAX; /* saturate beyond year 2262 */
+            else
+                fields->time_unix = (int64_t)t * 1000000;
+            fields->time = t * 10000 + UUID_TIMEOFFSET_TICKS;
+            fields->flags |= UUID_DEC_TIME;
+            break;
+        default:
+            break;
+    }
+    return;
+}
+
+/* decode UUID object into its fields */
+uuid_rc_t uuid_decode(const uuid_t *uuid, uuid_fields_t *fields)
+{
+    uuid_uint8_t bin[UUID_LEN_BIN];
+    void *bin_ptr;
+    size_t bin_len;
+    uuid_rc_t rc;
+
+    /* sanity check argument(s) */
+    if (uuid == NULL || fields == NULL)
+        return UUID_RC_ARG;
+
+    /* pack into binary representation and decode from there */
+    bin_ptr = (void *)bin;
+    bin_len = sizeof(bin);
+    if ((rc = uuid_export_bin(uuid, &bin_ptr, &bin_len)) != UUID_RC_OK)
+        return rc;
+    uuid_decode_octets(bin, fields);
+    return UUID_RC_OK;
+}
+
+/* decode an array of UUIDs in binary representation into their fields */
+uuid_rc_t uuid_decode_bin(const void *data_ptr, size_t count, uuid_fields_t *fields)
+{
+    const uuid_uint8_t *bin;
+    size_t i;
+
+    /* sanity check argument(s) */
+    if ((data_ptr == NULL || fields == NULL) && count > 0)
+        return UUID_RC_ARG;
+
+    bin = (const uuid_uint8_t *)data_ptr;
+    for (i = 0; i < count; i++, bin += UUID_LEN_BIN)
+        uuid_decode_octets(bin, &fields[i]);
+    return UUID_RC_OK;
+}
+
 /* INTERNAL: brand UUID with version and variant */
 static void uuid_brand(uuid_t *uuid, unsigned int version)
 {
@@ -914,6 +1458,9 @@ static uuid_rc_t uuid_make_v1(uuid_t *uuid, unsigned int mode, va_list ap)
 
         /* stall the UUID generation until the system clock (which
            has a gettimeofday(2) resolution of 1us) catches up */
+        uuid->stats.v1_stalls++;
+        uuid->stats_urgent = 1;
+        UUID_PROBE2(v1__stall, uuid->time_seq, uuid->stats.v1_stalls);
         time_usleep(1);
     }
 
@@ -957,6 +1504,11 @@ static uuid_rc_t uuid_make_v1(uuid_t *uuid, unsigned int mode, va_list ap)
         || (   time_now.tv_sec < uuid->time_last.tv_sec
             || (   time_now.tv_sec == uuid->time_last.tv_sec
                 && time_now.tv_usec < uuid->time_last.tv_usec))) {
+        if (clck != 0) {
+            uuid->stats.v1_backsteps++;
+            uuid->stats_urgent = 1;
+            UUID_PROBE1(v1__backstep, clck);
+        }
         if (prng_data(uuid->prng, (void *)&clck, sizeof(clck)) != PRNG_RC_OK)
             return UUID_RC_INT;
     }
@@ -1173,6 +1725,124 @@ static uuid_rc_t uuid_make_v5(uuid_t *uuid, unsigned int mode, va_list ap)
     return UUID_RC_OK;
 }
 
+/* INTERNAL: generate UUID version 7: Unix Epoch time and random number based */
+static uuid_rc_t uuid_make_v7(uuid_t *uuid, unsigned int mode, va_list ap)
+{
+    struct timeval time_now;
+    ui64_t t;
+    ui64_t ov;
+    uuid_uint8_t rnd[8];
+
+    (void)mode;
+    (void)ap;
+
+    /* determine current system time */
+    if (time_gettimeofday(&time_now) == -1)
+        return UUID_RC_SYS;
+
+    /* convert from timeval (sec,usec) to 48 bit milliseconds plus a 12 bit
+       sub-millisecond fraction (RFC 9562, section 6.2, method 3) */
+    t = ui64_n2i((unsigned long)time_now.tv_sec);
+    t = ui64_muln(t, 1000, NULL);
+    t = ui64_addn(t, (int)(time_now.tv_usec / 1000), NULL);
+    t = ui64_muln(t, 4096, NULL);
+    t = ui64_addn(t, (int)(((time_now.tv_usec % 1000) * 4096) / 1000), NULL);
+
+    /* keep the UUIDs of this object strictly monotonic, even if
+       the system time did not advance or stepped backwards */
+    if (ui64_cmp(t, uuid->time_v7) <= 0) {
+        t = ui64_addn(uuid->time_v7, 1, NULL);
+        uuid->stats.v7_clamps++;
+    }
+    uuid->time_v7 = t;
+
+    /* store the 60 bit timestamp in the UUID */
+    t = ui64_rol(t, 4, &ov);
+    t = ui64_rol(t, 32, &ov);
+    uuid->obj.time_low =
+        (uuid_uint32_t)(ui64_i2n(ov) & 0xffffffff); /* all 32 bit */
+    t = ui64_rol(t, 16, &ov);
+    uuid->obj.time_mid =
+        (uuid_uint16_t)(ui64_i2n(ov) & 0x0000ffff); /* all 16 bit */
+    t = ui64_rol(t, 12, &ov);
+    uuid->obj.time_hi_and_version =
+        (uuid_uint16_t)(ui64_i2n(ov) & 0x00000fff); /* 12 of 16 bit only! */
+
+    /* fill remaining part with random data */
+    if (prng_data(uuid->prng, (void *)rnd, sizeof(rnd)) != PRNG_RC_OK)
+        return UUID_RC_INT;
+    uuid->obj.clock_seq_hi_and_reserved = rnd[0];
+    uuid->obj.clock_seq_low = rnd[1];
+    memcpy(uuid->obj.node, rnd + 2, sizeof(uuid->obj.node));
+
+    /* brand UUID with version and variant */
+    uuid_brand(uuid, 7);
+
+    return UUID_RC_OK;
+}
+
+/* INTERNAL: generate ULID: Unix Epoch time and random number based,
+   monotonic within the same millisecond (ULID specification) */
+static uuid_rc_t uuid_make_ulid(uuid_t *uuid, unsigned int mode, va_list ap)
+{
+    struct timeval time_now;
+    ui64_t t;
+    ui64_t ov;
+    uuid_uint8_t *rnd;
+    int i;
+
+    (void)mode;
+    (void)ap;
+
+    /* determine current system time */
+    if (time_gettimeofday(&time_now) == -1)
+        return UUID_RC_SYS;
+
+    /* convert from timeval (sec,usec) to 48 bit milliseconds */
+    t = ui64_n2i((unsigned long)time_now.tv_sec);
+    t = ui64_muln(t, 1000, NULL);
+    t = ui64_addn(t, (int)(time_now.tv_usec / 1000), NULL);
+
+    /* within the same millisecond (or if the system time stepped
+       backwards) keep the previous timestamp and increment the
+       previous random part instead of choosing a new one; only if
+       the random part overflows, advance the timestamp */
+    rnd = uuid->rand_ulid;
+    if (ui64_cmp(t, uuid->time_ulid) <= 0) {
+        t = uuid->time_ulid;
+        for (i = (int)sizeof(uuid->rand_ulid) - 1; i >= 0; i--)
+            if (++rnd[i] != 0)
+                break;
+        if (i < 0)
+            t = ui64_addn(t, 1, NULL);
+        uuid->stats.ulid_increments++;
+    }
+    else {
+        if (prng_data(uuid->prng, (void *)rnd, sizeof(uuid->rand_ulid)) != PRNG_RC_OK)
+            return UUID_RC_INT;
+    }
+    uuid->time_ulid = t;
+
+    /* store the 48 bit timestamp in the first 6 octets */
+    t = ui64_rol(t, 16, &ov);
+    t = ui64_rol(t, 32, &ov);
+    uuid->obj.time_low =
+        (uuid_uint32_t)(ui64_i2n(ov) & 0xffffffff); /* all 32 bit */
+    t = ui64_rol(t, 16, &ov);
+    uuid->obj.time_mid =
+        (uuid_uint16_t)(ui64_i2n(ov) & 0x0000ffff); /* all 16 bit */
+
+    /* store the 80 bit random part in the remaining 10 octets
+       (a ULID carries neither a version nor a variant) */
+    uuid->obj.time_hi_and_version =
+        (uuid_uint16_t)(((uuid_uint16_t)rnd[0] << 8) | rnd[1]);
+    uuid->obj.clock_seq_hi_and_reserved = rnd[2];
+    uuid->obj.clock_seq_low = rnd[3];
+    memcpy(uuid->obj.node, rnd + 4, sizeof(uuid->obj.node));
+
+    return UUID_RC_OK;
+}
+
 /* generate UUID */
 uuid_rc_t uuid_make(uuid_t *uuid, unsigned int mode, ...)
 {
@@ -1183,6 +1853,8 @@ uuid_rc_t uuid_make(uuid_t *uuid, unsigned int mode, ...)
     if (uuid == NULL)
         return UUID_RC_ARG;
 
+    UUID_PROBE1(make__entry, mode);
+
     /* dispatch into version dependent generation functions */
     va_start(ap, mode);
     if (mode & UUID_MAKE_V1)
@@ -1193,10 +1865,20 @@ uuid_rc_t uuid_make(uuid_t *uuid, unsigned int mode, ...)
         rc = uuid_make_v4(uuid, mode, ap);
     else if (mode & UUID_MAKE_V5)
         rc = uuid_make_v5(uuid, mode, ap);
+    else if (mode & UUID_MAKE_V7)
+        rc = uuid_make_v7(uuid, mode, ap);
+    else if (mode & UUID_MAKE_ULID)
+        rc = uuid_make_ulid(uuid, mode, ap);
     else
         rc = UUID_RC_ARG;
     va_end(ap);
 
+    /* account the call and fold the event counters from time to time
+       (or immediately after a rare event) */
+    if (++uuid->stats.make >= UUID_STATS_BATCH || uuid->stats_urgent)
+        uuid_stats_fold(uuid);
+
+    UUID_PROBE2(make__return, mode, rc);
     return rc;
 }
 
@@ -1217,6 +1899,32 @@ char *uuid_error(uuid_rc_t rc)
     return str;
 }
 
+/* retrieve process-wide generator statistics */
+uuid_rc_t uuid_stats(uuid_t *uuid, uuid_stats_t *stats)
+{
+    /* sanity check argument(s) */
+    if (stats == NULL)
+        return UUID_RC_ARG;
+
+    /* bring the counters of the caller's object up-to-date */
+    if (uuid != NULL)
+        uuid_stats_fold(uuid);
+
+    /* copy out the process-wide statistics */
+    stats->make                = uuid_stats_all.make;
+    stats->v1_stalls           = uuid_stats_all.v1_stalls;
+    stats->v1_backsteps        = uuid_stats_all.v1_backsteps;
+    stats->v7_clamps           = uuid_stats_all.v7_clamps;
+    stats->ulid_increments     = uuid_stats_all.ulid_increments;
+    stats->prng_dev_reads      = uuid_stats_all.prng_dev_reads;
+    stats->prng_dev_bytes      = uuid_stats_all.prng_dev_bytes;
+    stats->prng_dev_errors     = uuid_stats_all.prng_dev_errors;
+    stats->prng_fallbacks      = uuid_stats_all.prng_fallbacks;
+    stats->prng_fallback_bytes = uuid_stats_all.prng_fallback_bytes;
+
+    return UUID_RC_OK;
+}
+
 /* OSSP uuid version (link-time information) */
 unsigned long uuid_version(void)
 {
@@ -0,0 +1,680 @@
+/*
+**  OSSP uuid - Universally Unique Identifier
+**  Copyright (c) 2004-2008 Ralf S. Engelschall <rse@engelschall.com>
+**  Copyright (c) 2004-2008 The OSSP Project <http://www.ossp.org/>
+**
+**  This file is part of OSSP uuid, a library for the generation
+**  of UUIDs which can found at http://www.ossp.org/pkg/lib/uuid/
+**
+**  Permission to use, copy, modify, and distribute this software for
+**  any purpose with or without fee is hereby granted, provided that
+**  the above copyright notice and this permission notice appear in all
+**  copies.
+**
+**  THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+**  WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+**  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+**  IN NO EVENT SHALL THE AUTHORS AND COPYRIGHT HOLDERS AND THEIR
+**  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+**  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+**  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+**  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+**  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+**  OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+**  SUCH DAMAGE.
+**
+**  uuid_bench.c: micro-benchmark suite
+*/
+
+/* own headers */
+#include "uuid.h"
+#include "uuid_ac.h"
+#include "uuid_md5.h"
+#include "uuid_sha1.h"
+#include "uuid_prng.h"
+#include "uuid_time.h"
+#include "uuid_ui64.h"
+#include "uuid_ui128.h"
+
+/* system headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+
+/* offset between UUID and Unix Epoch time (see uuid.c) */
+#define UUID_TIMEOFFSET "01B21DD213814000"
+
+/* maximum number of repetitions per benchmark */
+#define BENCH_REPS_MAX 1000
+
+/* error handler */
+static void
+error(int ec, const char *str, ...)
+{
+    va_list ap;
+
+    va_start(ap, str);
+    fprintf(stderr, "uuid_bench:ERROR: ");
+    vfprintf(stderr, str, ap);
+    fprintf(stderr, "\n");
+    va_end(ap);
+    exit(ec);
+}
+
+/* usage handler */
+static void
+usage(const char *str, ...)
+{
+    va_list ap;
+
+    va_start(ap, str);
+    if (str != NULL) {
+        fprintf(stderr, "uuid_bench:ERROR: ");
+        vfprintf(stderr, str, ap);
+        fprintf(stderr, "\n");
+    }
+    fprintf(stderr, "usage: uuid_bench [-r repetitions] [-t milliseconds] [-o filename] [benchmark ...]\n");
+    va_end(ap);
+    exit(1);
+}
+
+/* monotonic time in nanoseconds */
+static double
+now_ns(void)
+{
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == -1)
+        error(1, "clock_gettime: %s", strerror(errno));
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+#else
+    struct timeval tv;
+
+    if (gettimeofday(&tv, NULL) == -1)
+        error(1, "gettimeofday: %s", strerror(errno));
+    return (double)tv.tv_sec * 1e9 + (double)tv.tv_usec * 1e3;
+#endif
+}
+
+/*
+ *  BENCHMARK FIXTURES
+ */
+
+/* sink for results which the compiler must not optimize away */
+static volatile unsigned long sink;
+
+/* shared fixtures (created once in fixtures_create()) */
+static uuid_t *fx_uuid;                     /* random v4 UUID           */
+static uuid_t *fx_uuid2;                    /* another random v4 UUID   */
+static uuid_t *fx_ns;                       /* namespace ns:URL         */
+static md5_t  *fx_md5;
+static sha1_t *fx_sha1;
+static prng_t *fx_prng;
+static char    fx_bin[UUID_LEN_BIN];         /* fx_uuid in BIN format    */
+static char    fx_bin2[UUID_LEN_BIN];        /* fx_uuid2 in BIN format   */
+static char    fx_str[UUID_LEN_STR+1];       /* fx_uuid in STR format    */
+static char    fx_siv[UUID_LEN_SIV+1];       /* fx_uuid in SIV format    */
+static char    fx_b64[UUID_LEN_B64+1];       /* fx_uuid in B64 format    */
+static char    fx_b32[UUID_LEN_B32+1];       /* fx_uuid in B32 format    */
+static char    fx_b58[UUID_LEN_B58+1];       /* fx_uuid in B58 format    */
+static unsigned char fx_data[4096];         /* input data for digests   */
+static unsigned char fx_out[4096];          /* output buffer            */
+static ui64_t  fx_u64a, fx_u64b;            /* ui64 operands            */
+static ui128_t fx_u128a, fx_u128b;          /* ui128 operands           */
+
+static void
+fixtures_create(void)
+{
+    uuid_rc_t rc;
+    size_t len;
+    void *vp;
+    int i;
+
+    if (   (rc = uuid_create(&fx_uuid))  != UUID_RC_OK
+        || (rc = uuid_create(&fx_uuid2)) != UUID_RC_OK
+        || (rc = uuid_create(&fx_ns))    != UUID_RC_OK)
+        error(1, "uuid_create: %s", uuid_error(rc));
+    if (   (rc = uuid_make(fx_uuid,  UUID_MAKE_V4)) != UUID_RC_OK
+        || (rc = uuid_make(fx_uuid2, UUID_MAKE_V4)) != UUID_RC_OK)
+        error(1, "uuid_make: %s", uuid_error(rc));
+    if ((rc = uuid_load(fx_ns, "ns:URL")) != UUID_RC_OK)
+        error(1, "uuid_load: %s", uuid_error(rc));
+    vp = fx_bin; len = sizeof(fx_bin);
+    if ((rc = uuid_export(fx_uuid, UUID_FMT_BIN, &vp, &len)) != UUID_RC_OK)
+        error(1, "uuid_export: %s", uuid_error(rc));
+    vp = fx_bin2; len = sizeof(fx_bin2);
+    if ((rc = uuid_export(fx_uuid2, UUID_FMT_BIN, &vp, &len)) != UUID_RC_OK)
+        error(1, "uuid_export: %s", uuid_error(rc));
+    vp = fx_str; len = sizeof(fx_str);
+    if ((rc = uuid_export(fx_uuid, UUID_FMT_STR, &vp, &len)) != UUID_RC_OK)
+        error(1, "uuid_export: %s", uuid_error(rc));
+    vp = fx_siv; len = sizeof(fx_siv);
+    if ((rc = uuid_export(fx_uuid, UUID_FMT_SIV, &vp, &len)) != UUID_RC_OK)
+        error(1, "uuid_export: %s", uuid_error(rc));
+    vp = fx_b64; len = sizeof(fx_b64);
+    if ((rc = uuid_export(fx_uuid, UUID_FMT_B64, &vp, &len)) != UUID_RC_OK)
+        error(1, "uuid_export: %s", uuid_error(rc));
+    vp = fx_b32; len = sizeof(fx_b32);
+    if ((rc = uuid_export(fx_uuid, UUID_FMT_B32, &vp, &len)) != UUID_RC_OK)
+        error(1, "uuid_export: %s", uuid_error(rc));
+    vp = fx_b58; len = sizeof(fx_b58);
+    if ((rc = uuid_export(fx_uuid, UUID_FMT_B58, &vp, &len)) != UUID_RC_OK)
+        error(1, "uuid_export: %s", uuid_error(rc));
+    if (md5_create(&fx_md5) != MD5_RC_OK)
+        error(1, "md5_create: failed");
+    if (sha1_create(&fx_sha1) != SHA1_RC_OK)
+        error(1, "sha1_create: failed");
+    if (prng_create(&fx_prng) != PRNG_RC_OK)
+        error(1, "prng_create: failed");
+    for (i = 0; i < (int)sizeof(fx_data); i++)
+        fx_data[i] = (unsigned char)(i * 131 + 7);
+    fx_u64a  = ui64_s2i("0123456789abcdef", NULL, 16);
+    fx_u64b  = ui64_s2i("00000000fedcba98", NULL, 16);
+    fx_u128a = ui128_s2i(fx_siv, NULL, 10);
+    fx_u128b = ui128_s2i("0000000000000000fedcba9876543210", NULL, 16);
+    return;
+}
+
+static void
+fixtures_destroy(void)
+{
+    uuid_destroy(fx_uuid);
+    uuid_destroy(fx_uuid2);
+    uuid_destroy(fx_ns);
+    md5_destroy(fx_md5);
+    sha1_destroy(fx_sha1);
+    prng_destroy(fx_prng);
+    return;
+}
+
+/*
+ *  BENCHMARK FUNCTIONS
+ *  (each one performs n operations)
+ */
+
+/* v1: the system time query of uuid_make_v1() */
+static void
+b_v1_clock(long n)
+{
+    struct timeval tv;
+
+    while (n-- > 0) {
+        time_gettimeofday(&tv);
+        sink += (unsigned long)tv.tv_usec;
+    }
+}
+
+/* v1: the timestamp building of uuid_make_v1() (timeval to 60 bit UUID time) */
+static void
+b_v1_timestamp(long n)
+{
+    struct timeval tv;
+    ui64_t t, offset, ov;
+    unsigned long r;
+
+    tv.tv_sec  = 1200000000;
+    tv.tv_usec = 123456;
+    while (n-- > 0) {
+        t = ui64_n2i((unsigned long)tv.tv_sec);
+        t = ui64_muln(t, 1000000, NULL);
+        t = ui64_addn(t, (int)tv.tv_usec, NULL);
+        t = ui64_muln(t, 10, NULL);
+        offset = ui64_s2i(UUID_TIMEOFFSET, NULL, 16);
+        t = ui64_add(t, offset, NULL);
+        t = ui64_addn(t, (int)(n & 7), NULL);
+        t = ui64_rol(t, 16, &ov);
+        r = ui64_i2n(ov) & 0x00000fff;
+        t = ui64_rol(t, 16, &ov);
+        r ^= ui64_i2n(ov) & 0x0000ffff;
+        t = ui64_rol(t, 32, &ov);
+        r ^= ui64_i2n(ov) & 0xffffffff;
+        sink += r;
+        tv.tv_usec = (tv.tv_usec + 1) % 1000000;
+    }
+}
+
+/* PRNG draws of various sizes */
+static void
+b_prng(long n, size_t len)
+{
+    while (n-- > 0) {
+        prng_data(fx_prng, fx_out, len);
+        sink += fx_out[0];
+    }
+}
+static void b_prng_2(long n)    { b_prng(n, 2);    }
+static void b_prng_16(long n)   { b_prng(n, 16);   }
+static void b_prng_64(long n)   { b_prng(n, 64);   }
+static void b_prng_1024(long n) { b_prng(n, 1024); }
+
+/* MD5 and SHA-1: raw compression throughput (one 64 byte block per update) */
+static void
+b_md5_block(long n)
+{
+    md5_init(fx_md5);
+    while (n-- > 0)
+        md5_update(fx_md5, fx_data, 64);
+}
+static void
+b_sha1_block(long n)
+{
+    sha1_init(fx_sha1);
+    while (n-- > 0)
+        sha1_update(fx_sha1, fx_data, 64);
+}
+
+/* MD5 and SHA-1: complete digest of a v3/v5 sized input (namespace + URL) */
+static void
+b_md5_digest(long n)
+{
+    void *vp;
+    size_t len;
+
+    while (n-- > 0) {
+        md5_init(fx_md5);
+        md5_update(fx_md5, fx_bin, UUID_LEN_BIN);
+        md5_update(fx_md5, "http://www.ossp.org/", 20);
+        vp = fx_out; len = sizeof(fx_out);
+        md5_store(fx_md5, &vp, &len);
+        sink += fx_out[0];
+    }
+}
+static void
+b_sha1_digest(long n)
+{
+    void *vp;
+    size_t len;
+
+    while (n-- > 0) {
+        sha1_init(fx_sha1);
+        sha1_update(fx_sha1, fx_bin, UUID_LEN_BIN);
+        sha1_update(fx_sha1, "http://www.ossp.org/", 20);
+        vp = fx_out; len = sizeof(fx_out);
+        sha1_store(fx_sha1, &vp, &len);
+        sink += fx_out[0];
+    }
+}
+
+/* ui64 primitives */
+static void
+b_ui64_add(long n)
+{
+    ui64_t x = fx_u64a;
+
+    while (n-- > 0)
+        x = ui64_add(x, fx_u64b, NULL);
+    sink += ui64_i2n(x);
+}
+static void
+b_ui64_mul(long n)
+{
+    ui64_t x = fx_u64a;
+
+    while (n-- > 0)
+        x = ui64_mul(x, fx_u64b, NULL);
+    sink += ui64_i2n(x);
+}
+static void
+b_ui64_divn(long n)
+{
+    ui64_t x;
+
+    while (n-- > 0) {
+        x = ui64_divn(fx_u64a, 10, NULL);
+        sink += ui64_i2n(x);
+    }
+}
+static void
+b_ui64_rol(long n)
+{
+    ui64_t x = fx_u64a;
+
+    while (n-- > 0)
+        x = ui64_rol(x, 16, NULL);
+    sink += ui64_i2n(x);
+}
+static void
+b_ui64_s2i(long n)
+{
+    while (n-- > 0)
+        sink += ui64_i2n(ui64_s2i(UUID_TIMEOFFSET, NULL, 16));
+}
+
+/* ui128 primitives */
+static void
+b_ui128_add(long n)
+{
+    ui128_t x = fx_u128a;
+
+    while (n-- > 0)
+        x = ui128_add(x, fx_u128b, NULL);
+    sink += ui128_i2n(x);
+}
+static void
+b_ui128_muln(long n)
+{
+    ui128_t x = fx_u128a;
+
+    while (n-- > 0)
+        x = ui128_muln(x, 10, NULL);
+    sink += ui128_i2n(x);
+}
+static void
+b_ui128_divn(long n)
+{
+    ui128_t x;
+    int ov;
+
+    while (n-- > 0) {
+        x = ui128_divn(fx_u128a, 10, &ov);
+        sink += ui128_i2n(x) + (unsigned long)ov;
+    }
+}
+static void
+b_ui128_i2s(long n)
+{
+    while (n-- > 0) {
+        ui128_i2s(fx_u128a, (char *)fx_out, sizeof(fx_out), 10);
+        sink += fx_out[0];
+    }
+}
+static void
+b_ui128_s2i(long n)
+{
+    while (n-- > 0)
+        sink += ui128_i2n(ui128_s2i(fx_siv, NULL, 10));
+}
+
+/* UUID codecs */
+static void
+b_import(long n, uuid_fmt_t fmt, const void *data, size_t len)
+{
+    while (n-- > 0)
+        if (uuid_import(fx_uuid, fmt, data, len) != UUID_RC_OK)
+            error(1, "uuid_import: failed");
+}
+static void b_import_bin(long n) { b_import(n, UUID_FMT_BIN, fx_bin, UUID_LEN_BIN);    }
+static void b_import_str(long n) { b_import(n, UUID_FMT_STR, fx_str, UUID_LEN_STR);    }
+static void b_import_siv(long n) { b_import(n, UUID_FMT_SIV, fx_siv, strlen(fx_siv)); }
+static void b_import_b64(long n) { b_import(n, UUID_FMT_B64, fx_b64, UUID_LEN_B64);    }
+static void b_import_b32(long n) { b_import(n, UUID_FMT_B32, fx_b32, UUID_LEN_B32);    }
+static void b_import_b58(long n) { b_import(n, UUID_FMT_B58, fx_b58, UUID_LEN_B58);    }
+
+static void
+b_export(long n, uuid_fmt_t fmt)
+{
+    void *vp;
+    size_t len;
+
+    while (n-- > 0) {
+        vp = fx_out; len = sizeof(fx_out);
+        if (uuid_export(fx_uuid, fmt, &vp, &len) != UUID_RC_OK)
+            error(1, "uuid_export: failed");
+        sink += fx_out[0];
+    }
+}
+static void b_export_bin(long n) { b_export(n, UUID_FMT_BIN); }
+static void b_export_str(long n) { b_export(n, UUID_FMT_STR); }
+static void b_export_siv(long n) { b_export(n, UUID_FMT_SIV); }
+static void b_export_b64(long n) { b_export(n, UUID_FMT_B64); }
+static void b_export_b32(long n) { b_export(n, UUID_FMT_B32); }
+static void b_export_b58(long n) { b_export(n, UUID_FMT_B58); }
+static void b_export_txt(long n) { b_export(n, UUID_FMT_TXT); }
+
+/* UUID generation */
+static void
+b_make(long n, unsigned int mode)
+{
+    uuid_rc_t rc;
+
+    while (n-- > 0) {
+        if (mode == UUID_MAKE_V3 || mode == UUID_MAKE_V5)
+            rc = uuid_make(fx_uuid2, mode, fx_ns, "http://www.ossp.org/");
+        else
+            rc = uuid_make(fx_uuid2, mode);
+        if (rc != UUID_RC_OK)
+            error(1, "uuid_make: %s", uuid_error(rc));
+    }
+}
+static void b_make_v1(long n) { b_make(n, UUID_MAKE_V1); }
+static void b_make_v3(long n) { b_make(n, UUID_MAKE_V3); }
+static void b_make_v4(long n) { b_make(n, UUID_MAKE_V4); }
+static void b_make_v5(long n) { b_make(n, UUID_MAKE_V5); }
+static void b_make_v7(long n) { b_make(n, UUID_MAKE_V7); }
+
+/* the classic PostgreSQL binding comparison: create two UUID
+   objects, import both datums, compare and destroy them again */
+static void
+b_pgsql_compare(long n)
+{
+    uuid_t *uuid1, *uuid2;
+    int result;
+
+    while (n-- > 0) {
+        if (uuid_create(&uuid1) != UUID_RC_OK || uuid_create(&uuid2) != UUID_RC_OK)
+            error(1, "uuid_create: failed");
+        if (   uuid_import(uuid1, UUID_FMT_BIN, fx_bin,  UUID_LEN_BIN) != UUID_RC_OK
+            || uuid_import(uuid2, UUID_FMT_BIN, fx_bin2, UUID_LEN_BIN) != UUID_RC_OK)
+            error(1, "uuid_import: failed");
+        if (uuid_compare(uuid1, uuid2, &result) != UUID_RC_OK)
+            error(1, "uuid_compare: failed");
+        uuid_destroy(uuid2);
+        uuid_destroy(uuid1);
+        sink += (unsigned long)result;
+    }
+}
+
+/* the current PostgreSQL binding comparison: memcmp(3) of the datums */
+static void
+b_pgsql_memcmp(long n)
+{
+    while (n-- > 0)
+        sink += (unsigned long)memcmp(fx_bin, fx_bin2, UUID_LEN_BIN);
+}
+
+/* table of all benchmarks */
+static const struct {
+    const char *name;         /* benchmark name                     */
+    size_t      bytes;        /* bytes processed per operation or 0 */
+    void      (*func)(long);  /* run n operations                   */
+} benchmarks[] = {
+    { "v1-clock",       0,    b_v1_clock      },
+    { "v1-timestamp",   0,    b_v1_timestamp  },
+    { "prng-2",         2,    b_prng_2        },
+    { "prng-16",        16,   b_prng_16       },
+    { "prng-64",        64,   b_prng_64       },
+    { "prng-1024",      1024, b_prng_1024     },
+    { "md5-block",      64,   b_md5_block     },
+    { "md5-digest",     36,   b_md5_digest    },
+    { "sha1-block",     64,   b_sha1_block    },
+    { "sha1-digest",    36,   b_sha1_digest   },
+    { "ui64-add",       0,    b_ui64_add      },
+    { "ui64-mul",       0,    b_ui64_mul      },
+    { "ui64-divn",      0,    b_ui64_divn     },
+    { "ui64-rol",       0,    b_ui64_rol      },
+    { "ui64-s2i",       0,    b_ui64_s2i      },
+    { "ui128-add",      0,    b_ui128_add     },
+    { "ui128-muln",     0,    b_ui128_muln    },
+    { "ui128-divn",     0,    b_ui128_divn    },
+    { "ui128-i2s",      0,    b_ui128_i2s     },
+    { "ui128-s2i",      0,    b_ui128_s2i     },
+    { "import-bin",     0,    b_import_bin    },
+    { "import-str",     0,    b_import_str    },
+    { "import-siv",     0,    b_import_siv    },
+    { "import-b64",     0,    b_import_b64    },
+    { "import-b32",     0,    b_import_b32    },
+    { "import-b58",     0,    b_import_b58    },
+    { "export-bin",     0,    b_export_bin    },
+    { "export-str",     0,    b_export_str    },
+    { "export-siv",     0,    b_export_siv    },
+    { "export-b64",     0,    b_export_b64    },
+    { "export-b32",     0,    b_export_b32    },
+    { "export-b58",     0,    b_export_b58    },
+    { "export-txt",     0,    b_export_txt    },
+    { "make-v1",        0,    b_make_v1       },
+    { "make-v3",        0,    b_make_v3       },
+    { "make-v4",        0,    b_make_v4       },
+    { "make-v5",        0,    b_make_v5       },
+    { "make-v7",        0,    b_make_v7       },
+    { "pgsql-compare",  0,    b_pgsql_compare },
+    { "pgsql-memcmp",   0,    b_pgsql_memcmp  }
+};
+
+/*
+ *  BENCHMARK DRIVER
+ */
+
+/* qsort(3) callback for sample values */
+static int
+cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x < y ? -1 : (x > y ? 1 : 0));
+}
+
+/* run one benchmark: calibrate, warm up, repeat and summarize */
+static void
+bench_run(int i, int reps, double target_ns, FILE *fp, int first)
+{
+    double samples[BENCH_REPS_MAX];
+    double t0, t, mean, var, median;
+    long n;
+    int r;
+
+    /* calibrate: find the number of operations per repetition
+       which takes about the target time (this is also the warmup) */
+    n = 1;
+    for (;;) {
+        t0 = now_ns();
+        benchmarks[i].func(n);
+        t = now_ns() - t0;
+        if (t >= target_ns / 8 || n >= (1L << 30))
+            break;
+        n *= 2;
+    }
+    if (t > 0)
+        n = (long)((double)n * target_ns / t);
+    if (n < 1)
+        n = 1;
+    benchmarks[i].func(n);
+
+    /* repetitions */
+    for (r = 0; r < reps; r++) {
+        t0 = now_ns();
+        benchmarks[i].func(n);
+        samples[r] = (now_ns() - t0) / (double)n;
+    }
+
+    /* statistical summary (in ns per operation) */
+    mean = 0;
+    for (r = 0; r < reps; r++)
+        mean += samples[r];
+    mean /= reps;
+    var = 0;
+    for (r = 0; r < reps; r++)
+        var += (samples[r] - mean) * (samples[r] - mean);
+    var = (reps > 1 ? var / (reps - 1) : 0);
+    qsort(samples, reps, sizeof(double), cmp_double);
+    median = (reps % 2 == 1 ? samples[reps / 2]
+                            : (samples[reps / 2 - 1] + samples[reps / 2]) / 2);
+
+    fprintf(fp, "%s    {\"name\":\"%s\",\"iterations\":%ld,\"repetitions\":%d,"
+            "\"ns_per_op\":{\"min\":%.3f,\"median\":%.3f,\"mean\":%.3f,\"stddev\":%.3f,\"max\":%.3f},"
+            "\"ops_per_sec\":%.0f",
+            (first ? "" : ",\n"), benchmarks[i].name, n, reps,
+            samples[0], median, mean, sqrt(var), samples[reps - 1], 1e9 / median);
+    if (benchmarks[i].bytes > 0)
+        fprintf(fp, ",\"bytes_per_op\":%lu,\"mb_per_sec\":%.2f",
+                (unsigned long)benchmarks[i].bytes,
+                (double)benchmarks[i].bytes * 1e3 / median);
+    fprintf(fp, "}");
+    fprintf(stderr, "%-16s %12.3f ns/op (+/- %.3f)\n", benchmarks[i].name, median, sqrt(var));
+    return;
+}
+
+/* main procedure */
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    char *p;
+    int ch;
+    int reps;
+    long ms;
+    int i, j;
+    int first;
+
+    /* command line parsing */
+    fp = stdout;        /* default output file */
+    reps = 10;          /* default number of repetitions */
+    ms = 50;            /* default time per repetition */
+    while ((ch = getopt(argc, argv, "r:t:o:h")) != -1) {
+        switch (ch) {
+            case 'r':
+                reps = strtol(optarg, &p, 10);
+                if (*p != '\0' || reps < 1 || reps > BENCH_REPS_MAX)
+                    usage("invalid argument to option 'r'");
+                break;
+            case 't':
+                ms = strtol(optarg, &p, 10);
+                if (*p != '\0' || ms < 1)
+                    usage("invalid argument to option 't'");
+                break;
+            case 'o':
+                if (fp != stdout)
+                    error(1, "multiple output files are not allowed");
+                if ((fp = fopen(optarg, "w")) == NULL)
+                    error(1, "fopen: %s", strerror(errno));
+                break;
+            case 'h':
+                usage(NULL);
+                break;
+            default:
+                usage("invalid option '%c'", optopt);
+        }
+    }
+    argv += optind;
+    argc -= optind;
+    for (j = 0; j < argc; j++) {
+        for (i = 0; i < (int)(sizeof(benchmarks)/sizeof(benchmarks[0])); i++)
+            if (strncmp(benchmarks[i].name, argv[j], strlen(argv[j])) == 0)
+                break;
+        if (i == (int)(sizeof(benchmarks)/sizeof(benchmarks[0])))
+            usage("unknown benchmark \"%s\"", argv[j]);
+    }
+
+    /* run all (or the selected) benchmarks */
+    fixtures_create();
+    fprintf(fp, "{\n  \"suite\":\"uuid_bench\",\n  \"version\":\"0x%06lx\",\n"
+            "  \"repetitions\":%d,\n  \"target_ms\":%ld,\n  \"benchmarks\":[\n",
+            uuid_version(), reps, ms);
+    first = 1;
+    for (i = 0; i < (int)(sizeof(benchmarks)/sizeof(benchmarks[0])); i++) {
+        if (argc > 0) {
+            for (j = 0; j < argc; j++)
+                if (strncmp(benchmarks[i].name, argv[j], strlen(argv[j])) == 0)
+                    break;
+            if (j == argc)
+                continue;
+        }
+        bench_run(i, reps, (double)ms * 1e6, fp, first);
+        first = 0;
+    }
+    fprintf(fp, "\n  ]\n}\n");
+    fixtures_destroy();
+
+    /* close output channel */
+    if (fp != stdout)
+        fclose(fp);
+
+    return 0;
+}
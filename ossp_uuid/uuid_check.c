@@ -0,0 +1,103 @@
+/*
+**  OSSP uuid - Universally Unique Identifier
+**  Copyright (c) 2004-2008 Ralf S. Engelschall <rse@engelschall.com>
+**  Copyright (c) 2004-2008 The OSSP Project <http://www.ossp.org/>
+**
+**  This file is part of OSSP uuid, a library for the generation
+**  of UUIDs which can found at http://www.ossp.org/pkg/lib/uuid/
+**
+**  Permission to use, copy, modify, and distribute this software for
+**  any purpose with or without fee is hereby granted, provided that
+**  the above copyright notice and this permission notice appear in all
+**  copies.
+**
+**  THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+**  WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+**  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+**  IN NO EVENT SHALL THE AUTHORS AND COPYRIGHT HOLDERS AND THEIR
+**  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+**  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+**  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+**  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+**  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+**  OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+**  SUCH DAMAGE.
+**
+**  uuid_check.c: self-test of the C API (for "make check")
+*/
+
+/* own headers */
+#include "uuid.h"
+
+/* system headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* number of failed checks */
+static int failed = 0;
+
+/* check a single condition */
+#define CHECK(cond) \
+    do { if (!(cond)) { \
+        fprintf(stderr, "uuid_check:FAILED: %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        failed++; \
+    } } while (0)
+
+/* make a UUID and export its binary representation */
+static void
+make_bin(uuid_t *uuid, unsigned int mode, unsigned char *bin)
+{
+    void *vp;
+    size_t len;
+
+    vp  = bin;
+    len = UUID_LEN_BIN;
+    CHECK(uuid_make(uuid, mode) == UUID_RC_OK);
+    CHECK(uuid_export(uuid, UUID_FMT_BIN, &vp, &len) == UUID_RC_OK);
+    return;
+}
+
+/* a cloned ULID generator must not repeat the ULIDs of its original */
+static void
+check_clone_ulid(void)
+{
+    uuid_t *uuid, *clone;
+    unsigned char bin1[UUID_LEN_BIN], bin2[UUID_LEN_BIN];
+    unsigned char prev1[UUID_LEN_BIN], prev2[UUID_LEN_BIN];
+    int i, same;
+
+    CHECK(uuid_create(&uuid) == UUID_RC_OK);
+    make_bin(uuid, UUID_MAKE_ULID, prev1);
+    CHECK(uuid_clone(uuid, &clone) == UUID_RC_OK);
+    same = 0;
+    for (i = 0; i < 1000; i++) {
+        make_bin(uuid,  UUID_MAKE_ULID, bin1);
+        make_bin(clone, UUID_MAKE_ULID, bin2);
+        if (memcmp(bin1, bin2, UUID_LEN_BIN) == 0)
+            same++;
+        /* each object stays monotonic on its own */
+        CHECK(memcmp(prev1, bin1, UUID_LEN_BIN) < 0);
+        CHECK(i == 0 || memcmp(prev2, bin2, UUID_LEN_BIN) < 0);
+        memcpy(prev1, bin1, UUID_LEN_BIN);
+        memcpy(prev2, bin2, UUID_LEN_BIN);
+    }
+    CHECK(same == 0);
+    uuid_destroy(clone);
+    uuid_destroy(uuid);
+    return;
+}
+
+/* main procedure */
+int
+main(void)
+{
+    check_clone_ulid();
+    if (failed > 0) {
+        fprintf(stderr, "uuid_check: %d check(s) FAILED\n", failed);
+        return 1;
+    }
+    fprintf(stdout, "C API: OK\n");
+    return 0;
+}
@@ -38,6 +38,36 @@
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#else
+/* without POSIX threads all work is done by the main thread,
+   so the locking of the shared contexts degrades to no-ops
+   (macros, as <sys/types.h> may already declare the types) */
+#define pthread_mutex_t           int
+#define pthread_cond_t            int
+#define pthread_mutex_init(m, a)  (void)(*(m) = 0)
+#define pthread_mutex_destroy(m)  (void)(m)
+#define pthread_mutex_lock(m)     (void)(m)
+#define pthread_mutex_unlock(m)   (void)(m)
+#define pthread_cond_init(c, a)   (void)(*(c) = 0)
+#define pthread_cond_destroy(c)   (void)(c)
+#define pthread_cond_broadcast(c) (void)(c)
+#endif
+
+/* memory mapping of input files (if supported) */
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP)
+#define USE_MMAP 1
+#endif
 
 /* error handler */
 static void
@@ -65,12 +95,1249 @@ usage(const char *str, ...)
         vfprintf(stderr, str, ap);
         fprintf(stderr, "\n");
     }
-    fprintf(stderr, "usage: uuid [-v version] [-m] [-n count] [-1] [-F format] [-o filename] [namespace name]\n");
+    fprintf(stderr, "usage: uuid [-v version] [-m] [-n count] [-1] [-t threads] [-S [-j]] [-F format] [-o filename] [namespace name]\n");
+    fprintf(stderr, "usage: uuid -v version [-t threads] [-F format] [-o filename] -N filename namespace\n");
     fprintf(stderr, "usage: uuid -d [-F format] [-o filename] [uuid]\n");
+    fprintf(stderr, "usage: uuid -d -s [-j] [-F format] [-o filename] [filename]\n");
+    fprintf(stderr, "usage: uuid -B [-j] [-n count] [-t threads] [-o filename] [test ...]\n");
     va_end(ap);
     exit(1);
 }
 
+/* length of fixed-size text formats (0 for variable-size ones) */
+static size_t
+fmt_len(uuid_fmt_t fmt)
+{
+    switch (fmt) {
+        case UUID_FMT_STR: return UUID_LEN_STR;
+        case UUID_FMT_B64: return UUID_LEN_B64;
+        case UUID_FMT_B32: return UUID_LEN_B32;
+        case UUID_FMT_B58: return UUID_LEN_B58;
+        case UUID_FMT_ULID: return UUID_LEN_ULID;
+        default:           return 0;
+    }
+}
+
+/* long option aliases (mapped onto the short options) */
+static const struct {
+    const char *name;
+    const char *opt;
+} longopts[] = {
+    { "threads", "-t" },
+    { "stream",  "-s" },
+    { "json",    "-j" },
+    { "names-from", "-N" },
+    { "bench",   "-B" },
+    { "stats",   "-S" }
+};
+
+/* map "--name[=value]" arguments onto "-o[value]" for getopt(3) */
+static char **
+longopts_map(int argc, char *argv[])
+{
+    char **nargv;
+    size_t len;
+    int i, j;
+
+    if ((nargv = (char **)malloc((argc + 1) * sizeof(char *))) == NULL)
+        error(1, "malloc: %s", strerror(errno));
+    for (i = 0; i < argc; i++) {
+        nargv[i] = argv[i];
+        if (i == 0 || strncmp(argv[i], "--", 2) != 0)
+            continue;
+        if (argv[i][2] == '\0') {
+            /* end of options */
+            for (i++; i < argc; i++)
+                nargv[i] = argv[i];
+            break;
+        }
+        for (j = 0; j < (int)(sizeof(longopts)/sizeof(longopts[0])); j++) {
+            len = strlen(longopts[j].name);
+            if (strncmp(argv[i]+2, longopts[j].name, len) != 0)
+                continue;
+            if (argv[i][2+len] == '\0')
+                nargv[i] = (char *)longopts[j].opt;
+            else if (argv[i][2+len] == '=') {
+                if ((nargv[i] = (char *)malloc(2 + strlen(argv[i]+2+len+1) + 1)) == NULL)
+                    error(1, "malloc: %s", strerror(errno));
+                strcpy(nargv[i], longopts[j].opt);
+                strcat(nargv[i], argv[i]+2+len+1);
+            }
+            else
+                continue;
+            break;
+        }
+        if (j == (int)(sizeof(longopts)/sizeof(longopts[0])))
+            usage("invalid option '%s'", argv[i]);
+    }
+    nargv[argc] = NULL;
+    return nargv;
+}
+
+/* number of UUIDs per output block of the bulk writer */
+#define BULK_BLOCK 16384
+
+/* bulk generation context (shared by all worker threads) */
+typedef struct {
+    unsigned int version;     /* UUID_MAKE_XXX mode       */
+    uuid_t      *uuid_ns;     /* namespace (v3/v5 only)   */
+    const char  *name;        /* name (v3/v5 only)        */
+    const char  *init;        /* initial UUID (or NULL)   */
+    uuid_fmt_t   fmt;         /* output format            */
+    int          iterate;     /* reset context each time  */
+    int          fd;          /* output file descriptor   */
+    long         remaining;   /* UUIDs not yet claimed    */
+    pthread_mutex_t lock;     /* protects remaining and fd */
+} bulk_t;
+
+/* write a buffer completely */
+static void
+bulk_write(int fd, const char *buf, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        if ((n = write(fd, buf, len)) < 0) {
+            if (errno == EINTR)
+                continue;
+            error(1, "write: %s", strerror(errno));
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return;
+}
+
+/* render a block of new UUIDs into a buffer of n*(UUID_LEN_SIV+1) bytes */
+static size_t
+bulk_render(bulk_t *bulk, uuid_t *uuid, char *buf, long n)
+{
+    uuid_rc_t rc;
+    char *cp;
+    void *vp;
+    size_t len;
+    long i;
+
+    cp = buf;
+    for (i = 0; i < n; i++) {
+        if (bulk->iterate) {
+            if ((rc = uuid_load(uuid, "nil")) != UUID_RC_OK)
+                error(1, "uuid_load: %s", uuid_error(rc));
+        }
+        if (bulk->version == UUID_MAKE_V3 || bulk->version == UUID_MAKE_V5)
+            rc = uuid_make(uuid, bulk->version, bulk->uuid_ns, bulk->name);
+        else
+            rc = uuid_make(uuid, bulk->version);
+        if (rc != UUID_RC_OK)
+            error(1, "uuid_make: %s", uuid_error(rc));
+        /* export directly into the output block */
+        vp  = cp;
+        len = (bulk->fmt == UUID_FMT_BIN ? UUID_LEN_BIN : UUID_LEN_SIV+1);
+        if ((rc = uuid_export(uuid, bulk->fmt, &vp, &len)) != UUID_RC_OK)
+            error(1, "uuid_export: %s", uuid_error(rc));
+        if (bulk->fmt == UUID_FMT_BIN)
+            cp += UUID_LEN_BIN;
+        else {
+            cp += (bulk->fmt == UUID_FMT_STR ? UUID_LEN_STR : strlen(cp));
+            *cp++ = '\n';
+        }
+    }
+    return (size_t)(cp - buf);
+}
+
+/* bulk generation worker: claim, render and write blocks until done */
+static void *
+bulk_worker(void *ctx)
+{
+    bulk_t *bulk = (bulk_t *)ctx;
+    uuid_t *uuid;
+    uuid_rc_t rc;
+    char *buf;
+    size_t len;
+    long n;
+
+    if ((rc = uuid_create(&uuid)) != UUID_RC_OK)
+        error(1, "uuid_create: %s", uuid_error(rc));
+    if (bulk->init != NULL) {
+        /* load initial UUID for setting old generator state */
+        if ((rc = uuid_import(uuid, UUID_FMT_STR, bulk->init, strlen(bulk->init))) != UUID_RC_OK)
+            error(1, "uuid_import: %s", uuid_error(rc));
+    }
+    if ((buf = (char *)malloc(BULK_BLOCK * (UUID_LEN_SIV+1))) == NULL)
+        error(1, "malloc: %s", strerror(errno));
+    for (;;) {
+        pthread_mutex_lock(&bulk->lock);
+        n = (bulk->remaining < BULK_BLOCK ? bulk->remaining : BULK_BLOCK);
+        bulk->remaining -= n;
+        pthread_mutex_unlock(&bulk->lock);
+        if (n == 0)
+            break;
+        len = bulk_render(bulk, uuid, buf, n);
+        pthread_mutex_lock(&bulk->lock);
+        bulk_write(bulk->fd, buf, len);
+        pthread_mutex_unlock(&bulk->lock);
+    }
+    free(buf);
+    if ((rc = uuid_destroy(uuid)) != UUID_RC_OK)
+        error(1, "uuid_destroy: %s", uuid_error(rc));
+    return NULL;
+}
+
+/* size of the input and output buffers of the stream decoder */
+#define STREAM_BUFSIZE (1024*1024)
+
+/* stream decoding context */
+typedef struct {
+    uuid_fmt_t     fmt;       /* input format             */
+    int            json;      /* JSON instead of TSV      */
+    uuid_t        *uuid;      /* context for SIV import   */
+    unsigned long  records;   /* number of input records  */
+    unsigned long  invalid;   /* number of invalid ones   */
+    int            fd;        /* output file descriptor   */
+    char          *out;       /* output buffer            */
+    size_t         outlen;    /* used output buffer bytes */
+    long           day;       /* cached day number ...    */
+    char           date[11];  /* ... and its "YYYY-MM-DD" */
+} stream_t;
+
+/* value of hexadecimal digit (or -1) */
+static int
+hexval(int c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+/* parse the string representation (without any allocation) */
+static int
+stream_parse_str(const char *str, size_t len, unsigned char *bin)
+{
+    int i, j, hi, lo;
+
+    if (len != UUID_LEN_STR)
+        return 0;
+    for (i = 0, j = 0; i < UUID_LEN_BIN; i++) {
+        if (j == 8 || j == 13 || j == 18 || j == 23) {
+            if (str[j] != '-')
+                return 0;
+            j++;
+        }
+        if ((hi = hexval(str[j])) < 0 || (lo = hexval(str[j+1])) < 0)
+            return 0;
+        bin[i] = (unsigned char)((hi << 4) | lo);
+        j += 2;
+    }
+    return 1;
+}
+
+/* append decimal number with at least the given number of digits */
+static char *
+put_dec(char *cp, uint64_t v, int width)
+{
+    char tmp[20];
+    int n;
+
+    n = 0;
+    do {
+        tmp[n++] = (char)('0' + (v % 10));
+        v /= 10;
+    } while (v > 0);
+    while (n < width)
+        tmp[n++] = '0';
+    while (n > 0)
+        *cp++ = tmp[--n];
+    return cp;
+}
+
+/* append string */
+static char *
+put_str(char *cp, const char *str)
+{
+    while (*str != '\0')
+        *cp++ = *str++;
+    return cp;
+}
+
+/* append UTC time in ISO 8601 format from seconds and fraction since Unix Epoch */
+static char *
+put_time(stream_t *st, char *cp, uint64_t sec, uint64_t frac, int digits)
+{
+    long day, y, m, d, era, doe, yoe, doy, mp;
+    uint64_t tod;
+
+    /* convert day number into civil date (cached, as it rarely changes) */
+    day = (long)(sec / 86400);
+    tod = sec % 86400;
+    if (day != st->day) {
+        d   = day + 719468;
+        era = d / 146097;
+        doe = d - era * 146097;
+        yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+        y   = yoe + era * 400;
+        doy = doe - (365*yoe + yoe/4 - yoe/100);
+        mp  = (5*doy + 2) / 153;
+        d   = doy - (153*mp + 2)/5 + 1;
+        m   = (mp < 10 ? mp + 3 : mp - 9);
+        if (m <= 2)
+            y++;
+        put_dec(st->date, (uint64_t)y, 4);
+        st->date[4] = '-';
+        put_dec(st->date+5, (uint64_t)m, 2);
+        st->date[7] = '-';
+        put_dec(st->date+8, (uint64_t)d, 2);
+        st->date[10] = '\0';
+        st->day = day;
+    }
+    cp = put_str(cp, st->date);
+    *cp++ = 'T';
+    cp = put_dec(cp, tod / 3600, 2);
+    *cp++ = ':';
+    cp = put_dec(cp, (tod / 60) % 60, 2);
+    *cp++ = ':';
+    cp = put_dec(cp, tod % 60, 2);
+    *cp++ = '.';
+    cp = put_dec(cp, frac, digits);
+    *cp++ = 'Z';
+    return cp;
+}
+
+/* append one compact record for a UUID in binary representation */
+static void
+stream_record(stream_t *st, const unsigned char *bin)
+{
+    static const char hex[] = "0123456789abcdef";
+    static const char *fields[] = { "uuid", "version", "variant", "time", "clock", "node" };
+    static const char *variants[] = { "ncs", "dce", "microsoft", "future" };
+    uuid_fields_t dec;
+    uint64_t ticks;
+    char *cp;
+    int i, f;
+
+    /* flush output buffer if it cannot take another record */
+    if (st->outlen > STREAM_BUFSIZE - 256) {
+        bulk_write(st->fd, st->out, st->outlen);
+        st->outlen = 0;
+    }
+    cp = st->out + st->outlen;
+
+    /* decode variant, version, time, clock sequence and node */
+    (void)uuid_decode_bin(bin, 1, &dec);
+
+    for (f = 0; f < 6; f++) {
+        /* field separator and name */
+        if (st->json) {
+            *cp++ = (f == 0 ? '{' : ',');
+            *cp++ = '"';
+            cp = put_str(cp, fields[f]);
+            *cp++ = '"';
+            *cp++ = ':';
+        }
+        else if (f > 0)
+            *cp++ = '\t';
+
+        /* field value ("null" or "-" if not applicable) */
+        if (f == 0) {
+            if (st->json)
+                *cp++ = '"';
+            for (i = 0; i < UUID_LEN_BIN; i++) {
+                if (i == 4 || i == 6 || i == 8 || i == 10)
+                    *cp++ = '-';
+                *cp++ = hex[bin[i] >> 4];
+                *cp++ = hex[bin[i] & 0x0f];
+            }
+            if (st->json)
+                *cp++ = '"';
+        }
+        else if (f == 1)
+            cp = put_dec(cp, dec.version, 1);
+        else if (f == 2) {
+            if (st->json)
+                *cp++ = '"';
+            cp = put_str(cp, variants[dec.variant]);
+            if (st->json)
+                *cp++ = '"';
+        }
+        else if (f == 3 && (dec.flags & UUID_DEC_TIME) && dec.time_unix >= 0) {
+            /* 100ns ticks (v1/v6) or milliseconds (v7) since 1970-01-01 */
+            ticks = dec.time - UINT64_C(0x01b21dd213814000);
+            if (st->json)
+                *cp++ = '"';
+            if (dec.version == 7)
+                cp = put_time(st, cp, ticks / 10000000, (ticks / 10000) % 1000, 3);
+            else
+                cp = put_time(st, cp, ticks / 10000000, ticks % 10000000, 7);
+            if (st->json)
+                *cp++ = '"';
+        }
+        else if (f == 4 && (dec.flags & UUID_DEC_NODE))
+            cp = put_dec(cp, dec.clock_seq, 1);
+        else if (f == 5 && (dec.flags & UUID_DEC_NODE)) {
+            if (st->json)
+                *cp++ = '"';
+            for (i = 0; i < (int)sizeof(dec.node); i++) {
+                if (i > 0)
+                    *cp++ = ':';
+                *cp++ = hex[dec.node[i] >> 4];
+                *cp++ = hex[dec.node[i] & 0x0f];
+            }
+            if (st->json)
+                *cp++ = '"';
+        }
+        else
+            cp = put_str(cp, st->json ? "null" : "-");
+    }
+    if (st->json)
+        *cp++ = '}';
+    *cp++ = '\n';
+    st->outlen = (size_t)(cp - st->out);
+    return;
+}
+
+/* decode one input line (STR or SIV format) */
+static void
+stream_line(stream_t *st, const char *line, size_t len)
+{
+    unsigned char bin[UUID_LEN_BIN];
+    char siv[UUID_LEN_SIV+1];
+    void *vp;
+    size_t n;
+    int ok;
+
+    if (len > 0 && line[len-1] == '\r')
+        len--;
+    if (len == 0)
+        return;
+    st->records++;
+    if (st->fmt == UUID_FMT_STR)
+        ok = stream_parse_str(line, len, bin);
+    else if (st->fmt == UUID_FMT_SIV && len > UUID_LEN_SIV)
+        ok = 0;
+    else {
+        /* the SIV parser stops at the first non-digit only, so the
+           (mapped) line has to be NUL-terminated for it */
+        if (st->fmt == UUID_FMT_SIV) {
+            memcpy(siv, line, len);
+            siv[len] = '\0';
+            line = siv;
+        }
+        vp = bin;
+        n  = sizeof(bin);
+        ok = (   (st->fmt == UUID_FMT_SIV || len == fmt_len(st->fmt))
+              && uuid_import(st->uuid, st->fmt, line, len) == UUID_RC_OK
+              && uuid_export(st->uuid, UUID_FMT_BIN, &vp, &n) == UUID_RC_OK);
+    }
+    if (!ok) {
+        st->invalid++;
+        fprintf(stderr, "uuid:WARNING: record %lu: invalid UUID \"%.*s\"\n",
+                st->records, (int)(len > 64 ? 64 : len), line);
+        return;
+    }
+    stream_record(st, bin);
+    return;
+}
+
+/* decode a buffer of input records, returning the number of consumed bytes
+   (an incomplete last record is left over unless this is the final buffer) */
+static size_t
+stream_buffer(stream_t *st, const char *buf, size_t len, int final)
+{
+    const char *cp, *end, *nl;
+
+    cp  = buf;
+    end = buf + len;
+    if (st->fmt == UUID_FMT_BIN) {
+        /* fixed-width binary records */
+        for (; (size_t)(end - cp) >= UUID_LEN_BIN; cp += UUID_LEN_BIN) {
+            st->records++;
+            stream_record(st, (const unsigned char *)cp);
+        }
+        if (final && cp < end)
+            error(1, "trailing %d bytes do not form a binary UUID", (int)(end - cp));
+        return (size_t)(cp - buf);
+    }
+    /* newline-delimited text records */
+    while (cp < end) {
+        if ((nl = (const char *)memchr(cp, '\n', (size_t)(end - cp))) == NULL) {
+            if (!final)
+                break;
+            nl = end;
+        }
+        stream_line(st, cp, (size_t)(nl - cp));
+        cp = (nl < end ? nl + 1 : nl);
+    }
+    return (size_t)(cp - buf);
+}
+
+/* decode a stream of UUIDs from a file (mmap'ed) or a pipe (read in large blocks) */
+static unsigned long
+stream_decode(const char *filename, uuid_fmt_t fmt, int json, int fd_out)
+{
+    stream_t st;
+#ifdef USE_MMAP
+    struct stat sb;
+#endif
+    uuid_rc_t rc;
+    char *buf;
+#ifdef USE_MMAP
+    void *map;
+#endif
+    size_t len, n;
+    ssize_t r;
+    int fd;
+
+    memset(&st, 0, sizeof(st));
+    st.fmt  = fmt;
+    st.json = json;
+    st.fd   = fd_out;
+    st.day  = -1;
+    if ((st.out = (char *)malloc(STREAM_BUFSIZE)) == NULL)
+        error(1, "malloc: %s", strerror(errno));
+    if ((rc = uuid_create(&st.uuid)) != UUID_RC_OK)
+        error(1, "uuid_create: %s", uuid_error(rc));
+
+    /* open input */
+    if (filename == NULL || strcmp(filename, "-") == 0)
+        fd = 0;
+    else if ((fd = open(filename, O_RDONLY)) == -1)
+        error(1, "open: %s: %s", filename, strerror(errno));
+
+#ifdef USE_MMAP
+    if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0
+        && (map = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) != MAP_FAILED) {
+        /* regular file: decode the whole mapping at once */
+#ifdef MADV_SEQUENTIAL
+        madvise(map, (size_t)sb.st_size, MADV_SEQUENTIAL);
+#endif
+        stream_buffer(&st, (const char *)map, (size_t)sb.st_size, 1);
+        munmap(map, (size_t)sb.st_size);
+    }
+    else
+#endif
+    {
+        /* pipe or similar: read in large blocks, keep incomplete records */
+        if ((buf = (char *)malloc(STREAM_BUFSIZE)) == NULL)
+            error(1, "malloc: %s", strerror(errno));
+        len = 0;
+        for (;;) {
+            if ((r = read(fd, buf + len, STREAM_BUFSIZE - len)) < 0) {
+                if (errno == EINTR)
+                    continue;
+                error(1, "read: %s", strerror(errno));
+            }
+            len += (size_t)r;
+            n = stream_buffer(&st, buf, len, r == 0);
+            if (r == 0)
+                break;
+            if (n == 0 && len == STREAM_BUFSIZE) {
+                /* a single record longer than the buffer is garbage anyway */
+                st.records++;
+                st.invalid++;
+                fprintf(stderr, "uuid:WARNING: record %lu: overlong record skipped\n", st.records);
+                n = len;
+            }
+            memmove(buf, buf + n, len - n);
+            len -= n;
+        }
+        free(buf);
+    }
+    if (fd != 0)
+        close(fd);
+
+    /* flush remaining output */
+    bulk_write(st.fd, st.out, st.outlen);
+    free(st.out);
+    if ((rc = uuid_destroy(st.uuid)) != UUID_RC_OK)
+        error(1, "uuid_destroy: %s", uuid_error(rc));
+    return st.invalid;
+}
+
+/* input bytes per chunk and chunks in flight of the name file mode */
+#define NAMES_CHUNK   (1024*1024)
+#define NAMES_RING    64
+#define NAMES_SEGMENT (64*1024*1024)
+
+/* name file mode: one chunk of input lines and its rendered output */
+typedef struct {
+    const char *beg;          /* first input byte          */
+    const char *end;          /* end of last input line    */
+    char       *out;          /* rendered output           */
+    size_t      outlen;       /* used output bytes         */
+    size_t      outcap;       /* allocated output bytes    */
+    int         done;         /* output complete           */
+} names_chunk_t;
+
+/* name file mode: context shared by all worker threads */
+typedef struct {
+    unsigned int    version;  /* UUID_MAKE_V3 or UUID_MAKE_V5 */
+    uuid_t         *uuid_ns;  /* shared namespace            */
+    uuid_fmt_t      fmt;      /* output format               */
+    const char     *pos;      /* next unclaimed input byte   */
+    const char     *end;      /* end of input segment        */
+    unsigned long   next;     /* next chunk number to claim  */
+    unsigned long   written;  /* chunks written so far       */
+    names_chunk_t   ring[NAMES_RING]; /* reordering buffer   */
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+} names_t;
+
+/* name file mode: render the UUIDs of all lines of a chunk */
+static void
+names_render(names_t *nm, uuid_t *uuid, names_chunk_t *ch, char **name, size_t *namecap)
+{
+    const char *cp, *nl;
+    uuid_rc_t rc;
+    size_t len;
+    void *vp;
+
+    ch->outlen = 0;
+    for (cp = ch->beg; cp < ch->end; cp = nl + 1) {
+        if ((nl = (const char *)memchr(cp, '\n', (size_t)(ch->end - cp))) == NULL)
+            nl = ch->end;
+        len = (size_t)(nl - cp);
+        if (len > 0 && cp[len-1] == '\r')
+            len--;
+        /* the API expects NUL-terminated names */
+        if (len + 1 > *namecap) {
+            *namecap = (len + 1) * 2;
+            if ((*name = (char *)realloc(*name, *namecap)) == NULL)
+                error(1, "realloc: %s", strerror(errno));
+        }
+        memcpy(*name, cp, len);
+        (*name)[len] = '\0';
+        if ((rc = uuid_make(uuid, nm->version, nm->uuid_ns, *name)) != UUID_RC_OK)
+            error(1, "uuid_make: %s", uuid_error(rc));
+        if (ch->outlen + UUID_LEN_SIV+1 > ch->outcap) {
+            ch->outcap = (ch->outcap == 0 ? 64*1024 : ch->outcap * 2);
+            if ((ch->out = (char *)realloc(ch->out, ch->outcap)) == NULL)
+                error(1, "realloc: %s", strerror(errno));
+        }
+        vp  = ch->out + ch->outlen;
+        len = (nm->fmt == UUID_FMT_BIN ? UUID_LEN_BIN : UUID_LEN_SIV+1);
+        if ((rc = uuid_export(uuid, nm->fmt, &vp, &len)) != UUID_RC_OK)
+            error(1, "uuid_export: %s", uuid_error(rc));
+        if (nm->fmt == UUID_FMT_BIN)
+            ch->outlen += UUID_LEN_BIN;
+        else {
+            ch->outlen += (nm->fmt == UUID_FMT_STR ? UUID_LEN_STR : strlen(ch->out + ch->outlen));
+            ch->out[ch->outlen++] = '\n';
+        }
+        if (nl == ch->end)
+            break;
+    }
+    return;
+}
+
+/* name file mode: claim the next chunk in input order, extended up
+   to the end of its last line (with the lock held) */
+static names_chunk_t *
+names_claim(names_t *nm)
+{
+    names_chunk_t *ch;
+    const char *end;
+
+    ch = &nm->ring[nm->next % NAMES_RING];
+    ch->beg = nm->pos;
+    if ((size_t)(nm->end - nm->pos) <= NAMES_CHUNK)
+        end = nm->end;
+    else if ((end = (const char *)memchr(nm->pos + NAMES_CHUNK, '\n',
+                                         (size_t)(nm->end - nm->pos - NAMES_CHUNK))) == NULL)
+        end = nm->end;
+    ch->end = end;
+    ch->done = 0;
+    nm->pos = (end < nm->end ? end + 1 : end);
+    nm->next++;
+    return ch;
+}
+
+#ifdef HAVE_PTHREAD
+/* name file mode: worker thread claiming line-aligned chunks in input order */
+static void *
+names_worker(void *ctx)
+{
+    names_t *nm = (names_t *)ctx;
+    names_chunk_t *ch;
+    uuid_t *uuid;
+    uuid_rc_t rc;
+    char *name;
+    size_t namecap;
+
+    if ((rc = uuid_create(&uuid)) != UUID_RC_OK)
+        error(1, "uuid_create: %s", uuid_error(rc));
+    name = NULL;
+    namecap = 0;
+    pthread_mutex_lock(&nm->lock);
+    for (;;) {
+        /* wait for a free slot in the reordering buffer */
+        while (nm->pos < nm->end && nm->next >= nm->written + NAMES_RING)
+            pthread_cond_wait(&nm->cond, &nm->lock);
+        if (nm->pos >= nm->end)
+            break;
+        ch = names_claim(nm);
+        pthread_mutex_unlock(&nm->lock);
+
+        names_render(nm, uuid, ch, &name, &namecap);
+
+        pthread_mutex_lock(&nm->lock);
+        ch->done = 1;
+        pthread_cond_broadcast(&nm->cond);
+    }
+    pthread_mutex_unlock(&nm->lock);
+    free(name);
+    if ((rc = uuid_destroy(uuid)) != UUID_RC_OK)
+        error(1, "uuid_destroy: %s", uuid_error(rc));
+    return NULL;
+}
+#endif
+
+/* name file mode: generate the UUIDs of one input segment with all threads
+   and write them in input order */
+static void
+names_segment(names_t *nm, const char *buf, size_t len, int threads, int fd)
+{
+    names_chunk_t *ch;
+#ifdef HAVE_PTHREAD
+    pthread_t *tid;
+    int i;
+#else
+    uuid_t *uuid;
+    uuid_rc_t rc;
+    char *name;
+    size_t namecap;
+#endif
+
+    nm->pos = buf;
+    nm->end = buf + len;
+    nm->next = 0;
+    nm->written = 0;
+#ifdef HAVE_PTHREAD
+    if ((tid = (pthread_t *)malloc(threads * sizeof(pthread_t))) == NULL)
+        error(1, "malloc: %s", strerror(errno));
+    for (i = 0; i < threads; i++)
+        if ((errno = pthread_create(&tid[i], NULL, names_worker, nm)) != 0)
+            error(1, "pthread_create: %s", strerror(errno));
+
+    /* write the chunks in input order as they become ready */
+    pthread_mutex_lock(&nm->lock);
+    for (;;) {
+        ch = &nm->ring[nm->written % NAMES_RING];
+        while (nm->written < nm->next && !ch->done)
+            pthread_cond_wait(&nm->cond, &nm->lock);
+        if (nm->written == nm->next) {
+            if (nm->pos >= nm->end)
+                break;
+            pthread_cond_wait(&nm->cond, &nm->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&nm->lock);
+        bulk_write(fd, ch->out, ch->outlen);
+        pthread_mutex_lock(&nm->lock);
+        ch->done = 0;
+        nm->written++;
+        pthread_cond_broadcast(&nm->cond);
+    }
+    pthread_mutex_unlock(&nm->lock);
+
+    for (i = 0; i < threads; i++)
+        pthread_join(tid[i], NULL);
+    free(tid);
+#else
+    /* single-threaded: render and write chunk by chunk */
+    (void)threads;
+    if ((rc = uuid_create(&uuid)) != UUID_RC_OK)
+        error(1, "uuid_create: %s", uuid_error(rc));
+    name = NULL;
+    namecap = 0;
+    while (nm->pos < nm->end) {
+        ch = names_claim(nm);
+        names_render(nm, uuid, ch, &name, &namecap);
+        bulk_write(fd, ch->out, ch->outlen);
+        nm->written++;
+    }
+    free(name);
+    if ((rc = uuid_destroy(uuid)) != UUID_RC_OK)
+        error(1, "uuid_destroy: %s", uuid_error(rc));
+#endif
+    return;
+}
+
+/* name file mode: generate v3/v5 UUIDs for all lines of a file (mmap'ed)
+   or a pipe (read in large segments) */
+static void
+names_from(const char *filename, unsigned int version, uuid_t *uuid_ns,
+           uuid_fmt_t fmt, int threads, int fd_out)
+{
+    names_t nm;
+#ifdef USE_MMAP
+    struct stat sb;
+    void *map;
+#endif
+    char *buf, *nl;
+    size_t len, n;
+    ssize_t r;
+    int fd, i, eof;
+
+    memset(&nm, 0, sizeof(nm));
+    nm.version = version;
+    nm.uuid_ns = uuid_ns;
+    nm.fmt     = fmt;
+    pthread_mutex_init(&nm.lock, NULL);
+    pthread_cond_init(&nm.cond, NULL);
+
+    /* open input */
+    if (strcmp(filename, "-") == 0)
+        fd = 0;
+    else if ((fd = open(filename, O_RDONLY)) == -1)
+        error(1, "open: %s: %s", filename, strerror(errno));
+
+#ifdef USE_MMAP
+    if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0
+        && (map = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) != MAP_FAILED) {
+        /* regular file: the whole mapping is a single segment */
+#ifdef MADV_SEQUENTIAL
+        madvise(map, (size_t)sb.st_size, MADV_SEQUENTIAL);
+#endif
+        names_segment(&nm, (const char *)map, (size_t)sb.st_size, threads, fd_out);
+        munmap(map, (size_t)sb.st_size);
+    }
+    else
+#endif
+    {
+        /* pipe or similar: read line-aligned segments */
+        if ((buf = (char *)malloc(NAMES_SEGMENT)) == NULL)
+            error(1, "malloc: %s", strerror(errno));
+        len = 0;
+        eof = 0;
+        while (!eof) {
+            while (len < NAMES_SEGMENT) {
+                if ((r = read(fd, buf + len, NAMES_SEGMENT - len)) < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    error(1, "read: %s", strerror(errno));
+                }
+                if (r == 0) {
+                    eof = 1;
+                    break;
+                }
+                len += (size_t)r;
+            }
+            /* process up to the last complete line (everything at EOF) */
+            n = len;
+            if (!eof) {
+                for (nl = buf + len - 1; nl >= buf && *nl != '\n'; nl--)
+                    ;
+                if (nl < buf)
+                    error(1, "name longer than %d bytes", NAMES_SEGMENT);
+                n = (size_t)(nl - buf) + 1;
+            }
+            if (n > 0)
+                names_segment(&nm, buf, n, threads, fd_out);
+            memmove(buf, buf + n, len - n);
+            len -= n;
+        }
+        free(buf);
+    }
+    if (fd != 0)
+        close(fd);
+
+    for (i = 0; i < NAMES_RING; i++)
+        free(nm.ring[i].out);
+    pthread_cond_destroy(&nm.cond);
+    pthread_mutex_destroy(&nm.lock);
+    return;
+}
+
+/* benchmark mode: operations per latency sample */
+#define BENCH_BATCH 64
+
+/* benchmark mode: kinds of operations */
+typedef enum {
+    BENCH_CREATE,             /* uuid_create + uuid_destroy */
+    BENCH_MAKE,               /* uuid_make                  */
+    BENCH_IMPORT,             /* uuid_import                */
+    BENCH_EXPORT,             /* uuid_export                */
+    BENCH_COMPARE             /* uuid_compare               */
+} bench_op_t;
+
+/* benchmark mode: table of all tests */
+static const struct {
+    const char  *name;        /* test name                  */
+    bench_op_t   op;          /* operation                  */
+    unsigned int mode;        /* UUID_MAKE_XXX (make only)  */
+    uuid_fmt_t   fmt;         /* UUID_FMT_XXX (import/export only) */
+} bench_tests[] = {
+    { "create",     BENCH_CREATE,  0,                         UUID_FMT_BIN },
+    { "make-v1",    BENCH_MAKE,    UUID_MAKE_V1,              UUID_FMT_BIN },
+    { "make-v1-mc", BENCH_MAKE,    UUID_MAKE_V1|UUID_MAKE_MC, UUID_FMT_BIN },
+    { "make-v3",    BENCH_MAKE,    UUID_MAKE_V3,              UUID_FMT_BIN },
+    { "make-v4",    BENCH_MAKE,    UUID_MAKE_V4,              UUID_FMT_BIN },
+    { "make-v5",    BENCH_MAKE,    UUID_MAKE_V5,              UUID_FMT_BIN },
+    { "make-v7",    BENCH_MAKE,    UUID_MAKE_V7,              UUID_FMT_BIN },
+    { "make-ulid",  BENCH_MAKE,    UUID_MAKE_ULID,            UUID_FMT_BIN },
+    { "import-bin", BENCH_IMPORT,  0,                         UUID_FMT_BIN },
+    { "import-str", BENCH_IMPORT,  0,                         UUID_FMT_STR },
+    { "import-siv", BENCH_IMPORT,  0,                         UUID_FMT_SIV },
+    { "import-b64", BENCH_IMPORT,  0,                         UUID_FMT_B64 },
+    { "import-b32", BENCH_IMPORT,  0,                         UUID_FMT_B32 },
+    { "import-b58", BENCH_IMPORT,  0,                         UUID_FMT_B58 },
+    { "export-bin", BENCH_EXPORT,  0,                         UUID_FMT_BIN },
+    { "export-str", BENCH_EXPORT,  0,                         UUID_FMT_STR },
+    { "export-siv", BENCH_EXPORT,  0,                         UUID_FMT_SIV },
+    { "export-b64", BENCH_EXPORT,  0,                         UUID_FMT_B64 },
+    { "export-b32", BENCH_EXPORT,  0,                         UUID_FMT_B32 },
+    { "export-b58", BENCH_EXPORT,  0,                         UUID_FMT_B58 },
+    { "export-txt", BENCH_EXPORT,  0,                         UUID_FMT_TXT },
+    { "compare",    BENCH_COMPARE, 0,                         UUID_FMT_BIN }
+};
+
+/* benchmark mode: context shared by all threads of one run */
+typedef struct {
+    int             test;     /* index into bench_tests[]   */
+    long            batches;  /* batches per thread         */
+    int             ready;    /* threads waiting at start   */
+    int             go;       /* start flag                 */
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+} bench_t;
+
+/* benchmark mode: per-thread state and results */
+typedef struct {
+    bench_t  *bench;          /* shared context             */
+    uint64_t  start;          /* monotonic start time (ns)  */
+    uint64_t  end;            /* monotonic end time (ns)    */
+    uint64_t *samples;        /* duration of each batch (ns) */
+} bench_thread_t;
+
+/* benchmark mode: monotonic time in nanoseconds */
+static uint64_t
+bench_now(void)
+{
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == -1)
+        error(1, "clock_gettime: %s", strerror(errno));
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+#else
+    struct timeval tv;
+
+    if (gettimeofday(&tv, NULL) == -1)
+        error(1, "gettimeofday: %s", strerror(errno));
+    return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+#endif
+}
+
+/* benchmark mode: run the batches of one test in one thread */
+static void *
+bench_worker(void *ctx)
+{
+    bench_thread_t *bt = (bench_thread_t *)ctx;
+    bench_t *bench = bt->bench;
+    bench_op_t op = bench_tests[bench->test].op;
+    unsigned int mode = bench_tests[bench->test].mode;
+    uuid_fmt_t fmt = bench_tests[bench->test].fmt;
+    uuid_t *uuid, *uuid2, *uuid_ns, *tmp;
+    char buf_txt[UUID_LEN_SIV+1];
+    char buf_bin[UUID_LEN_BIN];
+    char buf_out[UUID_LEN_SIV+1];
+    const void *data;
+    size_t data_len;
+    uuid_rc_t rc;
+    uint64_t t0, t1;
+    size_t len;
+    void *vp;
+    long b;
+    int i, r;
+
+    /* prepare contexts and input data outside of the timed loops */
+    if ((rc = uuid_create(&uuid)) != UUID_RC_OK)
+        error(1, "uuid_create: %s", uuid_error(rc));
+    if ((rc = uuid_create(&uuid2)) != UUID_RC_OK)
+        error(1, "uuid_create: %s", uuid_error(rc));
+    if ((rc = uuid_create(&uuid_ns)) != UUID_RC_OK)
+        error(1, "uuid_create: %s", uuid_error(rc));
+    if ((rc = uuid_load(uuid_ns, "ns:URL")) != UUID_RC_OK)
+        error(1, "uuid_load: %s", uuid_error(rc));
+    if (   (rc = uuid_make(uuid,  UUID_MAKE_V4)) != UUID_RC_OK
+        || (rc = uuid_make(uuid2, UUID_MAKE_V4)) != UUID_RC_OK)
+        error(1, "uuid_make: %s", uuid_error(rc));
+    vp = buf_bin; len = sizeof(buf_bin);
+    if ((rc = uuid_export(uuid, UUID_FMT_BIN, &vp, &len)) != UUID_RC_OK)
+        error(1, "uuid_export: %s", uuid_error(rc));
+    if (fmt == UUID_FMT_BIN || fmt == UUID_FMT_TXT) {
+        data = buf_bin; data_len = UUID_LEN_BIN;
+    }
+    else {
+        vp = buf_txt; len = sizeof(buf_txt);
+        if ((rc = uuid_export(uuid, fmt, &vp, &len)) != UUID_RC_OK)
+            error(1, "uuid_export: %s", uuid_error(rc));
+        data = buf_txt; data_len = strlen(buf_txt);
+    }
+
+#ifdef HAVE_PTHREAD
+    /* wait until all threads are ready */
+    pthread_mutex_lock(&bench->lock);
+    bench->ready++;
+    pthread_cond_broadcast(&bench->cond);
+    while (!bench->go)
+        pthread_cond_wait(&bench->cond, &bench->lock);
+    pthread_mutex_unlock(&bench->lock);
+#endif
+
+    /* timed loops */
+    rc = UUID_RC_OK;
+    bt->start = t0 = bench_now();
+    for (b = 0; b < bench->batches; b++) {
+        switch (op) {
+            case BENCH_CREATE:
+                for (i = 0; i < BENCH_BATCH && rc == UUID_RC_OK; i++)
+                    if ((rc = uuid_create(&tmp)) == UUID_RC_OK)
+                        rc = uuid_destroy(tmp);
+                break;
+            case BENCH_MAKE:
+                if (mode == UUID_MAKE_V3 || mode == UUID_MAKE_V5) {
+                    for (i = 0; i < BENCH_BATCH && rc == UUID_RC_OK; i++)
+                        rc = uuid_make(uuid, mode, uuid_ns, "http://www.ossp.org/");
+                }
+                else {
+                    for (i = 0; i < BENCH_BATCH && rc == UUID_RC_OK; i++)
+                        rc = uuid_make(uuid, mode);
+                }
+                break;
+            case BENCH_IMPORT:
+                for (i = 0; i < BENCH_BATCH && rc == UUID_RC_OK; i++)
+                    rc = uuid_import(uuid, fmt, data, data_len);
+                break;
+            case BENCH_EXPORT:
+                if (fmt == UUID_FMT_TXT) {
+                    for (i = 0; i < BENCH_BATCH && rc == UUID_RC_OK; i++) {
+                        vp = NULL;
+                        if ((rc = uuid_export(uuid, fmt, &vp, NULL)) == UUID_RC_OK)
+                            free(vp);
+                    }
+                }
+                else {
+                    for (i = 0; i < BENCH_BATCH && rc == UUID_RC_OK; i++) {
+                        vp = buf_out; len = sizeof(buf_out);
+                        rc = uuid_export(uuid, fmt, &vp, &len);
+                    }
+                }
+                break;
+            case BENCH_COMPARE:
+                for (i = 0; i < BENCH_BATCH && rc == UUID_RC_OK; i++)
+                    rc = uuid_compare(uuid, uuid2, &r);
+                break;
+        }
+        if (rc != UUID_RC_OK)
+            error(1, "%s: %s", bench_tests[bench->test].name, uuid_error(rc));
+        t1 = bench_now();
+        bt->samples[b] = t1 - t0;
+        t0 = t1;
+    }
+    bt->end = t0;
+
+    if (   (rc = uuid_destroy(uuid))    != UUID_RC_OK
+        || (rc = uuid_destroy(uuid2))   != UUID_RC_OK
+        || (rc = uuid_destroy(uuid_ns)) != UUID_RC_OK)
+        error(1, "uuid_destroy: %s", uuid_error(rc));
+    return NULL;
+}
+
+/* benchmark mode: qsort(3) callback for batch durations */
+static int
+bench_cmp(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x < y ? -1 : (x > y ? 1 : 0));
+}
+
+/* benchmark mode: run one test with a number of threads and report it */
+static void
+bench_run(int test, long batches, int threads, int json, FILE *fp)
+{
+    bench_t bench;
+    bench_thread_t *bt;
+#ifdef HAVE_PTHREAD
+    pthread_t *tid;
+#endif
+    uint64_t *all, start, end, busy;
+    double ops, wall, pct[4];
+    long n;
+    int i;
+
+    bench.test    = test;
+    bench.batches = batches;
+    bench.ready   = 0;
+    bench.go      = 0;
+    pthread_mutex_init(&bench.lock, NULL);
+    pthread_cond_init(&bench.cond, NULL);
+    n = batches * threads;
+    if (   (bt  = (bench_thread_t *)malloc(threads * sizeof(bench_thread_t))) == NULL
+        || (all = (uint64_t *)malloc(n * sizeof(uint64_t))) == NULL)
+        error(1, "malloc: %s", strerror(errno));
+    for (i = 0; i < threads; i++) {
+        bt[i].bench   = &bench;
+        bt[i].samples = all + (long)i * batches;
+    }
+
+#ifdef HAVE_PTHREAD
+    /* start all threads at once */
+    if ((tid = (pthread_t *)malloc(threads * sizeof(pthread_t))) == NULL)
+        error(1, "malloc: %s", strerror(errno));
+    for (i = 0; i < threads; i++)
+        if ((errno = pthread_create(&tid[i], NULL, bench_worker, &bt[i])) != 0)
+            error(1, "pthread_create: %s", strerror(errno));
+    pthread_mutex_lock(&bench.lock);
+    while (bench.ready < threads)
+        pthread_cond_wait(&bench.cond, &bench.lock);
+    bench.go = 1;
+    pthread_cond_broadcast(&bench.cond);
+    pthread_mutex_unlock(&bench.lock);
+    for (i = 0; i < threads; i++)
+        pthread_join(tid[i], NULL);
+    free(tid);
+#else
+    /* single-threaded: run the test directly */
+    bench.go = 1;
+    bench_worker(&bt[0]);
+#endif
+
+    /* aggregate: throughput over the wall clock time of all threads,
+       latency over the busy time of each thread */
+    start = bt[0].start;
+    end   = bt[0].end;
+    busy  = 0;
+    for (i = 0; i < threads; i++) {
+        if (bt[i].start < start)
+            start = bt[i].start;
+        if (bt[i].end > end)
+            end = bt[i].end;
+        busy += bt[i].end - bt[i].start;
+    }
+    ops  = (double)n * BENCH_BATCH;
+    wall = (double)(end - start) / 1e9;
+    if (wall <= 0)
+        wall = 1e-9;
+    /* percentiles of the mean latency per batch (timing single
+       operations would mostly measure the clock itself) */
+    qsort(all, n, sizeof(uint64_t), bench_cmp);
+    pct[0] = (double)all[(n - 1) * 50 / 100] / BENCH_BATCH;
+    pct[1] = (double)all[(n - 1) * 90 / 100] / BENCH_BATCH;
+    pct[2] = (double)all[(n - 1) * 99 / 100] / BENCH_BATCH;
+    pct[3] = (double)all[n - 1] / BENCH_BATCH;
+    if (json)
+        fprintf(fp, "{\"test\":\"%s\",\"threads\":%d,\"ops\":%.0f,\"seconds\":%.6f,"
+                "\"ops_per_sec\":%.0f,\"ns_per_op\":%.1f,"
+                "\"batch_p50_ns\":%.1f,\"batch_p90_ns\":%.1f,"
+                "\"batch_p99_ns\":%.1f,\"batch_max_ns\":%.1f}\n",
+                bench_tests[test].name, threads, ops, wall, ops / wall,
+                (double)busy / ops, pct[0], pct[1], pct[2], pct[3]);
+    else
+        fprintf(fp, "%s\t%d\t%.0f\t%.6f\t%.0f\t%.1f\t%.1f\t%.1f\t%.1f\t%.1f\n",
+                bench_tests[test].name, threads, ops, wall, ops / wall,
+                (double)busy / ops, pct[0], pct[1], pct[2], pct[3]);
+    fflush(fp);
+
+    free(all);
+    free(bt);
+    pthread_cond_destroy(&bench.cond);
+    pthread_mutex_destroy(&bench.lock);
+    return;
+}
+
+/* benchmark mode: check whether a test is selected by an argument
+   (exact name, or name prefix if the argument ends with "*") */
+static int
+bench_match(const char *name, const char *arg)
+{
+    size_t len;
+
+    len = strlen(arg);
+    if (len > 0 && arg[len-1] == '*')
+        return (strncmp(name, arg, len - 1) == 0);
+    return (strcmp(name, arg) == 0);
+}
+
+/* benchmark mode: run all (or the selected) tests with 1..N threads */
+static void
+bench_main(int argc, char *argv[], long count, int threads, int json, FILE *fp)
+{
+    long batches;
+    int test, t, i;
+
+    /* check test names */
+    for (i = 0; i < argc; i++) {
+        for (test = 0; test < (int)(sizeof(bench_tests)/sizeof(bench_tests[0])); test++)
+            if (bench_match(bench_tests[test].name, argv[i]))
+                break;
+        if (test == (int)(sizeof(bench_tests)/sizeof(bench_tests[0])))
+            usage("unknown benchmark test \"%s\"", argv[i]);
+    }
+
+    batches = (count + BENCH_BATCH - 1) / BENCH_BATCH;
+    if (!json)
+        fprintf(fp, "test\tthreads\tops\tseconds\tops_per_sec\tns_per_op\tbatch_p50_ns\tbatch_p90_ns\tbatch_p99_ns\tbatch_max_ns\n");
+    for (test = 0; test < (int)(sizeof(bench_tests)/sizeof(bench_tests[0])); test++) {
+        if (argc > 0) {
+            for (i = 0; i < argc; i++)
+                if (bench_match(bench_tests[test].name, argv[i]))
+                    break;
+            if (i == argc)
+                continue;
+        }
+        /* 1, 2, 4, ... threads and finally the maximum */
+        for (t = 1; t < threads; t *= 2)
+            bench_run(test, batches, t, json, fp);
+        bench_run(test, batches, threads, json, fp);
+    }
+    return;
+}
+
+/* generator statistics: output format (for the atexit(3) handler) */
+static int stats_json = 0;
+
+/* generator statistics: print to stderr on exit */
+static void
+stats_print(void)
+{
+    static const char *names[] = {
+        "make", "v1_stalls", "v1_backsteps", "v7_clamps", "ulid_increments",
+        "prng_dev_reads", "prng_dev_bytes", "prng_dev_errors",
+        "prng_fallbacks", "prng_fallback_bytes"
+    };
+    unsigned long values[10];
+    uuid_stats_t stats;
+    int i;
+
+    if (uuid_stats(NULL, &stats) != UUID_RC_OK)
+        return;
+    values[0] = stats.make;
+    values[1] = stats.v1_stalls;
+    values[2] = stats.v1_backsteps;
+    values[3] = stats.v7_clamps;
+    values[4] = stats.ulid_increments;
+    values[5] = stats.prng_dev_reads;
+    values[6] = stats.prng_dev_bytes;
+    values[7] = stats.prng_dev_errors;
+    values[8] = stats.prng_fallbacks;
+    values[9] = stats.prng_fallback_bytes;
+    for (i = 0; i < 10; i++) {
+        if (stats_json)
+            fprintf(stderr, "%s\"%s\":%lu", (i == 0 ? "{" : ","), names[i], values[i]);
+        else
+            fprintf(stderr, "%s\t%lu\n", names[i], values[i]);
+    }
+    if (stats_json)
+        fprintf(stderr, "}\n");
+    return;
+}
+
 /* main procedure */
 int main(int argc, char *argv[])
 {
@@ -81,25 +1348,44 @@ int main(int argc, char *argv[])
     uuid_t *uuid_ns;
     uuid_rc_t rc;
     FILE *fp;
+    size_t n;
     char *p;
     int ch;
     int count;
     int i;
     int iterate;
     uuid_fmt_t fmt;
+    int fmt_given;
     int decode;
     void *vp;
-    size_t n;
     unsigned int version;
+    int threads;
+    int stream;
+    int json;
+    const char *names;
+    int bench;
+    int stats;
+#ifdef HAVE_PTHREAD
+    pthread_t *tid;
+#endif
+    bulk_t bulk;
 
     /* command line parsing */
     count = -1;         /* no count yet */
     fp = stdout;        /* default output file */
     iterate = 0;        /* not one at a time */
     fmt = UUID_FMT_STR; /* default is ASCII output */
+    fmt_given = 0;      /* (or ULID text for ULIDs) */
     decode = 0;         /* default is to encode */
     version = UUID_MAKE_V1;
-    while ((ch = getopt(argc, argv, "1n:rF:dmo:v:h")) != -1) {
+    threads = 1;        /* default is single-threaded */
+    stream = 0;         /* default is to decode a single UUID */
+    json = 0;           /* default is TSV stream records */
+    names = NULL;       /* default is name from command line */
+    bench = 0;          /* default is no benchmark */
+    stats = 0;          /* default is no statistics */
+    argv = longopts_map(argc, argv);
+    while ((ch = getopt(argc, argv, "1n:rF:dsjmo:v:t:N:BSh")) != -1) {
         switch (ch) {
             case '1':
                 iterate = 1;
@@ -113,6 +1399,7 @@ int main(int argc, char *argv[])
                 break;
             case 'r':
                 fmt = UUID_FMT_BIN;
+                fmt_given = 1;
                 break;
             case 'F':
                 if (strcasecmp(optarg, "bin") == 0)
@@ -121,12 +1408,36 @@ int main(int argc, char *argv[])
                     fmt = UUID_FMT_STR;
                 else if (strcasecmp(optarg, "siv") == 0)
                     fmt = UUID_FMT_SIV;
+                else if (strcasecmp(optarg, "b64") == 0)
+                    fmt = UUID_FMT_B64;
+                else if (strcasecmp(optarg, "b32") == 0)
+                    fmt = UUID_FMT_B32;
+                else if (strcasecmp(optarg, "b58") == 0)
+                    fmt = UUID_FMT_B58;
+                else if (strcasecmp(optarg, "ulid") == 0)
+                    fmt = UUID_FMT_ULID;
                 else
-                    error(1, "invalid format \"%s\" (has to be \"bin\", \"str\" or \"siv\")", optarg);
+                    error(1, "invalid format \"%s\" (has to be \"bin\", \"str\", \"siv\", \"b64\", \"b32\", \"b58\" or \"ulid\")", optarg);
+                fmt_given = 1;
                 break;
             case 'd':
                 decode = 1;
                 break;
+            case 's':
+                stream = 1;
+                break;
+            case 'j':
+                json = 1;
+                break;
+            case 'N':
+                names = optarg;
+                break;
+            case 'B':
+                bench = 1;
+                break;
+            case 'S':
+                stats = 1;
+                break;
             case 'o':
                 if (fp != stdout)
                     error(1, "multiple output files are not allowed");
@@ -137,6 +1448,10 @@ int main(int argc, char *argv[])
                 version |= UUID_MAKE_MC;
                 break;
             case 'v':
+                if (strcasecmp(optarg, "ulid") == 0) {
+                    version = UUID_MAKE_ULID;
+                    break;
+                }
                 i = strtol(optarg, &p, 10);
                 if (*p != '\0')
                     usage("invalid argument to option 'v'");
@@ -145,11 +1460,28 @@ int main(int argc, char *argv[])
                     case 3: version = UUID_MAKE_V3; break;
                     case 4: version = UUID_MAKE_V4; break;
                     case 5: version = UUID_MAKE_V5; break;
+                    case 7: version = UUID_MAKE_V7; break;
                     default:
                         usage("invalid version on option 'v'");
                         break;
                 }
                 break;
+            case 't':
+                threads = strtol(optarg, &p, 10);
+                if (*p != '\0' || threads < 0)
+                    usage("invalid argument to option 't'");
+#ifdef HAVE_PTHREAD
+                if (threads == 0) {
+                    /* one thread per online CPU */
+                    if ((threads = (int)sysconf(_SC_NPROCESSORS_ONLN)) < 1)
+                        threads = 1;
+                }
+#else
+                /* the output does not depend on the number of threads,
+                   so without POSIX threads just run single-threaded */
+                threads = 1;
+#endif
+                break;
             case 'h':
                 usage(NULL);
                 break;
@@ -159,10 +1491,45 @@ int main(int argc, char *argv[])
     }
     argv += optind;
     argc -= optind;
+    if ((version & UUID_MAKE_ULID) && !fmt_given)
+        fmt = UUID_FMT_ULID;
+
+    if (stats) {
+        /* print generator statistics on exit */
+        stats_json = json;
+        if (atexit(stats_print) != 0)
+            error(1, "atexit: failed");
+    }
+
+    if (bench) {
+        /* benchmark */
+        if (decode || stream || names != NULL)
+            usage("option 'B' cannot be combined with options 'd', 's' and 'N'");
+        bench_main(argc, argv, (count == -1 ? 100000 : count), threads, json, fp);
+        if (fp != stdout)
+            fclose(fp);
+        return 0;
+    }
     if (count == -1)
         count = 1;
 
-    if (decode) {
+    if (stream && !decode)
+        usage("option 's' is only allowed in decoding mode");
+    if (json && !stream && !stats)
+        usage("option 'j' requires option 's', 'B' or 'S'");
+
+    if (decode && stream) {
+        /* stream decoding */
+        if (argc > 1)
+            usage("invalid number of arguments");
+        fflush(fp);
+        if (stream_decode(argc == 1 ? argv[0] : NULL, fmt, json, fileno(fp)) > 0) {
+            if (fp != stdout)
+                fclose(fp);
+            return 1;
+        }
+    }
+    else if (decode) {
         /* decoding */
         if ((rc = uuid_create(&uuid)) != UUID_RC_OK)
             error(1, "uuid_create: %s", uuid_error(rc));
@@ -189,6 +1556,14 @@ int main(int argc, char *argv[])
                 if ((rc = uuid_import(uuid, UUID_FMT_SIV, uuid_buf_siv, UUID_LEN_SIV)) != UUID_RC_OK)
                     error(1, "uuid_import: %s", uuid_error(rc));
             }
+            else {
+                n = fmt_len(fmt);
+                if (fread(uuid_buf_str, n, 1, stdin) != 1)
+                    error(1, "fread: failed to read %d bytes from stdin", (int)n);
+                uuid_buf_str[n] = '\0';
+                if ((rc = uuid_import(uuid, fmt, uuid_buf_str, n)) != UUID_RC_OK)
+                    error(1, "uuid_import: %s", uuid_error(rc));
+            }
         }
         else {
             if (fmt == UUID_FMT_BIN) {
@@ -202,6 +1577,12 @@ int main(int argc, char *argv[])
                 if ((rc = uuid_import(uuid, UUID_FMT_SIV, argv[0], strlen(argv[0]))) != UUID_RC_OK)
                     error(1, "uuid_import: %s", uuid_error(rc));
             }
+            else {
+                if (strlen(argv[0]) != fmt_len(fmt))
+                    error(1, "uuid_import: %s", uuid_error(UUID_RC_ARG));
+                if ((rc = uuid_import(uuid, fmt, argv[0], strlen(argv[0]))) != UUID_RC_OK)
+                    error(1, "uuid_import: %s", uuid_error(rc));
+            }
         }
         vp = NULL;
         if ((rc = uuid_export(uuid, UUID_FMT_TXT, &vp, NULL)) != UUID_RC_OK)
@@ -213,65 +1594,87 @@ int main(int argc, char *argv[])
     }
     else {
         /* encoding */
+        if (names != NULL) {
+            /* names from file */
+            if (version != UUID_MAKE_V3 && version != UUID_MAKE_V5)
+                usage("option 'N' requires version 3 or 5");
+            if (argc != 1)
+                usage("invalid number of arguments");
+            if (count != 1)
+                usage("options 'N' and 'n' are mutually exclusive");
+            if ((rc = uuid_create(&uuid_ns)) != UUID_RC_OK)
+                error(1, "uuid_create: %s", uuid_error(rc));
+            if ((rc = uuid_load(uuid_ns, argv[0])) != UUID_RC_OK) {
+                if ((rc = uuid_import(uuid_ns, UUID_FMT_STR, argv[0], strlen(argv[0]))) != UUID_RC_OK)
+                    error(1, "uuid_import: %s", uuid_error(rc));
+            }
+            fflush(fp);
+            names_from(names, version, uuid_ns, fmt, threads, fileno(fp));
+            if ((rc = uuid_destroy(uuid_ns)) != UUID_RC_OK)
+                error(1, "uuid_destroy: %s", uuid_error(rc));
+            if (fp != stdout)
+                fclose(fp);
+            return 0;
+        }
         if (   (version == UUID_MAKE_V1 && argc != 0)
             || (version == UUID_MAKE_V3 && argc != 2)
             || (version == UUID_MAKE_V4 && argc != 0)
-            || (version == UUID_MAKE_V5 && argc != 2))
+            || (version == UUID_MAKE_V5 && argc != 2)
+            || (version == UUID_MAKE_V7 && argc != 0)
+            || (version == UUID_MAKE_ULID && argc != 0))
             usage("invalid number of arguments");
-        if ((rc = uuid_create(&uuid)) != UUID_RC_OK)
-            error(1, "uuid_create: %s", uuid_error(rc));
-        if (argc == 1) {
-            /* load initial UUID for setting old generator state */
+        memset(&bulk, 0, sizeof(bulk));
+        bulk.version   = version;
+        bulk.fmt       = fmt;
+        bulk.iterate   = iterate;
+        bulk.remaining = count;
+        if (argc == 1 && version != UUID_MAKE_V3 && version != UUID_MAKE_V5) {
+            /* initial UUID for setting old generator state */
             if (strlen(argv[0]) != UUID_LEN_STR)
                 error(1, "invalid length of UUID string representation");
-            if ((rc = uuid_import(uuid, UUID_FMT_STR, argv[0], strlen(argv[0]))) != UUID_RC_OK)
-                error(1, "uuid_import: %s", uuid_error(rc));
+            bulk.init = argv[0];
         }
-        for (i = 0; i < count; i++) {
-            if (iterate) {
-                if ((rc = uuid_load(uuid, "nil")) != UUID_RC_OK)
-                    error(1, "uuid_load: %s", uuid_error(rc));
-            }
-            if (version == UUID_MAKE_V3 || version == UUID_MAKE_V5) {
-                if ((rc = uuid_create(&uuid_ns)) != UUID_RC_OK)
-                    error(1, "uuid_create: %s", uuid_error(rc));
-                if ((rc = uuid_load(uuid_ns, argv[0])) != UUID_RC_OK) {
-                    if ((rc = uuid_import(uuid_ns, UUID_FMT_STR, argv[0], strlen(argv[0]))) != UUID_RC_OK)
-                        error(1, "uuid_import: %s", uuid_error(rc));
-                }
-                if ((rc = uuid_make(uuid, version, uuid_ns, argv[1])) != UUID_RC_OK)
-                    error(1, "uuid_make: %s", uuid_error(rc));
-                if ((rc = uuid_destroy(uuid_ns)) != UUID_RC_OK)
-                    error(1, "uuid_destroy: %s", uuid_error(rc));
-            }
-            else {
-                if ((rc = uuid_make(uuid, version)) != UUID_RC_OK)
-                    error(1, "uuid_make: %s", uuid_error(rc));
-            }
-            if (fmt == UUID_FMT_BIN) {
-                vp = NULL;
-                if ((rc = uuid_export(uuid, UUID_FMT_BIN, &vp, &n)) != UUID_RC_OK)
-                    error(1, "uuid_export: %s", uuid_error(rc));
-                fwrite(vp, n, 1, fp);
-                free(vp);
-            }
-            else if (fmt == UUID_FMT_STR) {
-                vp = NULL;
-                if ((rc = uuid_export(uuid, UUID_FMT_STR, &vp, &n)) != UUID_RC_OK)
-                    error(1, "uuid_export: %s", uuid_error(rc));
-                fprintf(fp, "%s\n", (char *)vp);
-                free(vp);
-            }
-            else if (fmt == UUID_FMT_SIV) {
-                vp = NULL;
-                if ((rc = uuid_export(uuid, UUID_FMT_SIV, &vp, &n)) != UUID_RC_OK)
-                    error(1, "uuid_export: %s", uuid_error(rc));
-                fprintf(fp, "%s\n", (char *)vp);
-                free(vp);
+        if (version == UUID_MAKE_V3 || version == UUID_MAKE_V5) {
+            /* create namespace once for all UUIDs (and threads) */
+            if ((rc = uuid_create(&uuid_ns)) != UUID_RC_OK)
+                error(1, "uuid_create: %s", uuid_error(rc));
+            if ((rc = uuid_load(uuid_ns, argv[0])) != UUID_RC_OK) {
+                if ((rc = uuid_import(uuid_ns, UUID_FMT_STR, argv[0], strlen(argv[0]))) != UUID_RC_OK)
+                    error(1, "uuid_import: %s", uuid_error(rc));
             }
+            bulk.uuid_ns = uuid_ns;
+            bulk.name    = argv[1];
+        }
+        if (version == UUID_MAKE_V1) {
+            /* version 1 UUIDs with the real MAC address rely on the
+               time and clock sequence state of a single context */
+            threads = 1;
+        }
+
+        /* generate into large blocks which are written directly */
+        fflush(fp);
+        bulk.fd = fileno(fp);
+        pthread_mutex_init(&bulk.lock, NULL);
+#ifdef HAVE_PTHREAD
+        if (threads > 1 && count > BULK_BLOCK) {
+            if ((tid = (pthread_t *)malloc(threads * sizeof(pthread_t))) == NULL)
+                error(1, "malloc: %s", strerror(errno));
+            for (i = 0; i < threads; i++)
+                if ((errno = pthread_create(&tid[i], NULL, bulk_worker, &bulk)) != 0)
+                    error(1, "pthread_create: %s", strerror(errno));
+            for (i = 0; i < threads; i++)
+                pthread_join(tid[i], NULL);
+            free(tid);
+        }
+        else
+#endif
+            bulk_worker(&bulk);
+        pthread_mutex_destroy(&bulk.lock);
+
+        if (bulk.uuid_ns != NULL) {
+            if ((rc = uuid_destroy(bulk.uuid_ns)) != UUID_RC_OK)
+                error(1, "uuid_destroy: %s", uuid_error(rc));
         }
-        if ((rc = uuid_destroy(uuid)) != UUID_RC_OK)
-            error(1, "uuid_destroy: %s", uuid_error(rc));
     }
 
     /* close output channel */
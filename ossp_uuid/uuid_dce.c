@@ -47,8 +47,76 @@
 #include "uuid.h"
 #endif
 
-/* helper macro */
-#define LEAVE /*lint -save -e801*/ goto leave /*lint -restore*/
+/* include autoconf results */
+#include "uuid_ac.h"
+
+/* system headers */
+#include <stdlib.h>
+#include <string.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+/* storage class of the per-thread generator (if supported) */
+#if defined(_MSC_VER)
+#define UUID_DCE_TLS __declspec(thread)
+#elif defined(__GNUC__) || defined(__SUNPRO_C) || defined(__xlC__)
+#define UUID_DCE_TLS __thread
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define UUID_DCE_TLS _Thread_local
+#endif
+
+#ifdef UUID_DCE_TLS
+/* per-thread generator, created on first use and kept for all
+   further calls of this thread, so consecutive UUIDs share the PRNG,
+   MAC address and clock sequence state like with the regular API */
+static UUID_DCE_TLS uuid_t *uuid_dce_gen = NULL;
+#ifndef _MSC_VER
+static UUID_DCE_TLS pid_t uuid_dce_gen_pid = 0;
+#endif
+#if defined(HAVE_PTHREAD) && !defined(_MSC_VER)
+/* the generator is additionally registered under a thread-specific
+   key, whose destructor releases it when the thread exits (the TLS
+   pointer remains the fast path for all calls in between) */
+#define UUID_DCE_KEY 1
+#include <pthread.h>
+static pthread_key_t  uuid_dce_key;
+static pthread_once_t uuid_dce_key_once = PTHREAD_ONCE_INIT;
+static int            uuid_dce_key_ok = 0;
+
+/* thread exit: destroy the generator of this thread */
+static void uuid_dce_key_destroy(void *gen)
+{
+    uuid_destroy((uuid_t *)gen);
+    if (uuid_dce_gen == (uuid_t *)gen)
+        uuid_dce_gen = NULL;
+    return;
+}
+
+/* create the thread-specific key (once per process) */
+static void uuid_dce_key_create(void)
+{
+    if (pthread_key_create(&uuid_dce_key, uuid_dce_key_destroy) == 0)
+        uuid_dce_key_ok = 1;
+    return;
+}
+#endif
+#endif
+
+/* lower case hexadecimal digits */
+static const char uuid_dce_hex[] = "0123456789abcdef";
+
+/* value of hexadecimal digit (or -1) */
+static int uuid_dce_hexval(int c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
 
 /* create a UUID (v1 only) */
 void uuid_dce_create(uuid_dce_t *uuid_dce, int *status)
@@ -56,6 +124,7 @@ void uuid_dce_create(uuid_dce_t *uuid_dce, int *status)
     uuid_t *uuid;
     size_t len;
     void *vp;
+    uuid_rc_t rc;
 
     /* initialize status */
     if (status != NULL)
@@ -65,20 +134,45 @@ void uuid_dce_create(uuid_dce_t *uuid_dce, int *status)
     if (uuid_dce == NULL)
         return;
 
-    /* create UUID and export as binary representation */
+    /* determine generator */
+#ifdef UUID_DCE_TLS
+#ifndef _MSC_VER
+    if (uuid_dce_gen != NULL && uuid_dce_gen_pid != getpid()) {
+        /* do not continue the state of the parent process after fork(2) */
+        uuid_destroy(uuid_dce_gen);
+        uuid_dce_gen = NULL;
+    }
+#endif
+    if (uuid_dce_gen == NULL) {
+        if (uuid_create(&uuid_dce_gen) != UUID_RC_OK) {
+            uuid_dce_gen = NULL;
+            return;
+        }
+#ifndef _MSC_VER
+        uuid_dce_gen_pid = getpid();
+#endif
+#ifdef UUID_DCE_KEY
+        pthread_once(&uuid_dce_key_once, uuid_dce_key_create);
+        if (uuid_dce_key_ok)
+            pthread_setspecific(uuid_dce_key, uuid_dce_gen);
+#endif
+    }
+    uuid = uuid_dce_gen;
+#else
     if (uuid_create(&uuid) != UUID_RC_OK)
         return;
-    if (uuid_make(uuid, UUID_MAKE_V1) != UUID_RC_OK) {
-        uuid_destroy(uuid);
-        return;
-    }
+#endif
+
+    /* make UUID and export binary representation directly into the result */
     vp  = uuid_dce;
     len = UUID_LEN_BIN;
-    if (uuid_export(uuid, UUID_FMT_BIN, &vp, &len) != UUID_RC_OK) {
-        uuid_destroy(uuid);
-        return;
-    }
+    if ((rc = uuid_make(uuid, UUID_MAKE_V1)) == UUID_RC_OK)
+        rc = uuid_export(uuid, UUID_FMT_BIN, &vp, &len);
+#ifndef UUID_DCE_TLS
     uuid_destroy(uuid);
+#endif
+    if (rc != UUID_RC_OK)
+        return;
 
     /* return successfully */
     if (status != NULL)
@@ -142,9 +236,7 @@ int uuid_dce_is_nil(uuid_dce_t *uuid_dce, int *status)
 /* compare two UUIDs */
 int uuid_dce_compare(uuid_dce_t *uuid_dce1, uuid_dce_t *uuid_dce2, int *status)
 {
-    uuid_t *uuid1 = NULL;
-    uuid_t *uuid2 = NULL;
-    int result = 0;
+    int result;
 
     /* initialize status */
     if (status != NULL)
@@ -154,28 +246,14 @@ int uuid_dce_compare(uuid_dce_t *uuid_dce1, uuid_dce_t *uuid_dce2, int *status)
     if (uuid_dce1 == NULL || uuid_dce2 == NULL)
         return 0;
 
-    /* import both UUID binary representations and compare them */
-    if (uuid_create(&uuid1) != UUID_RC_OK)
-        LEAVE;
-    if (uuid_create(&uuid2) != UUID_RC_OK)
-        LEAVE;
-    if (uuid_import(uuid1, UUID_FMT_BIN, uuid_dce1, UUID_LEN_BIN) != UUID_RC_OK)
-        LEAVE;
-    if (uuid_import(uuid2, UUID_FMT_BIN, uuid_dce2, UUID_LEN_BIN) != UUID_RC_OK)
-        LEAVE;
-    if (uuid_compare(uuid1, uuid2, &result) != UUID_RC_OK)
-        LEAVE;
-
-    /* indicate successful operation */
+    /* short-circuit implementation, because the binary representation
+       is in network byte order and hence compares like the UUID fields */
+    result = memcmp(uuid_dce1, uuid_dce2, UUID_LEN_BIN);
+    result = (result < 0 ? -1 : (result > 0 ? 1 : 0));
+
+    /* return successfully with result */
     if (status != NULL)
         *status = uuid_s_ok;
-
-    /* cleanup and return */
-    leave:
-    if (uuid1 != NULL)
-        uuid_destroy(uuid1);
-    if (uuid2 != NULL)
-        uuid_destroy(uuid2);
     return result;
 }
 
@@ -190,16 +268,17 @@ int uuid_dce_equal(uuid_dce_t *uuid_dce1, uuid_dce_t *uuid_dce2, int *status)
     if (uuid_dce1 == NULL || uuid_dce2 == NULL)
         return 0;
 
-    /* pass through to generic compare function */
-    return (uuid_dce_compare(uuid_dce1, uuid_dce2, status) == 0 ? 1 : 0);
+    /* return successfully with result */
+    if (status != NULL)
+        *status = uuid_s_ok;
+    return (memcmp(uuid_dce1, uuid_dce2, UUID_LEN_BIN) == 0 ? 1 : 0);
 }
 
 /* import UUID from string representation */
 void uuid_dce_from_string(const char *str, uuid_dce_t *uuid_dce, int *status)
 {
-    uuid_t *uuid = NULL;
-    size_t len;
-    void *vp;
+    unsigned char bin[UUID_LEN_BIN];
+    int i, j, hi, lo;
 
     /* initialize status */
     if (status != NULL)
@@ -209,33 +288,34 @@ void uuid_dce_from_string(const char *str, uuid_dce_t *uuid_dce, int *status)
     if (str == NULL || uuid_dce == NULL)
         return;
 
-    /* import string representation and export binary representation */
-    if (uuid_create(&uuid) != UUID_RC_OK)
-        LEAVE;
-    if (uuid_import(uuid, UUID_FMT_STR, str, UUID_LEN_STR) != UUID_RC_OK)
-        LEAVE;
-    vp  = uuid_dce;
-    len = UUID_LEN_BIN;
-    if (uuid_export(uuid, UUID_FMT_BIN, &vp, &len) != UUID_RC_OK)
-        LEAVE;
+    /* short-circuit implementation, because the string representation
+       ("xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx") is trivial to parse,
+       so no need to use regular OSSP uuid API */
+    for (i = 0, j = 0; i < UUID_LEN_BIN; i++) {
+        if (j == 8 || j == 13 || j == 18 || j == 23) {
+            if (str[j] != '-')
+                return;
+            j++;
+        }
+        if ((hi = uuid_dce_hexval(str[j])) < 0 || (lo = uuid_dce_hexval(str[j+1])) < 0)
+            return;
+        bin[i] = (unsigned char)((hi << 4) | lo);
+        j += 2;
+    }
+    memcpy(uuid_dce, bin, UUID_LEN_BIN);
 
-    /* indicate successful operation */
+    /* return successfully */
     if (status != NULL)
         *status = uuid_s_ok;
-
-    /* cleanup and return */
-    leave:
-    if (uuid != NULL)
-        uuid_destroy(uuid);
     return;
 }
 
 /* export UUID to string representation */
 void uuid_dce_to_string(uuid_dce_t *uuid_dce, char **str, int *status)
 {
-    uuid_t *uuid = NULL;
-    size_t len;
-    void *vp;
+    const unsigned char *ucp;
+    char *cp;
+    int i;
 
     /* initialize status */
     if (status != NULL)
@@ -245,24 +325,23 @@ void uuid_dce_to_string(uuid_dce_t *uuid_dce, char **str, int *status)
     if (str == NULL || uuid_dce == NULL)
         return;
 
-    /* import binary representation and export string representation */
-    if (uuid_create(&uuid) != UUID_RC_OK)
-        LEAVE;
-    if (uuid_import(uuid, UUID_FMT_BIN, uuid_dce, UUID_LEN_BIN) != UUID_RC_OK)
-        LEAVE;
-    vp  = str;
-    len = UUID_LEN_STR;
-    if (uuid_export(uuid, UUID_FMT_STR, &vp, &len) != UUID_RC_OK)
-        LEAVE;
-
-    /* indicate successful operation */
+    /* short-circuit implementation, because the string representation
+       is trivial to format, so no need to use regular OSSP uuid API */
+    if ((cp = (char *)malloc(UUID_LEN_STR+1)) == NULL)
+        return;
+    *str = cp;
+    ucp = (const unsigned char *)uuid_dce;
+    for (i = 0; i < UUID_LEN_BIN; i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10)
+            *cp++ = '-';
+        *cp++ = uuid_dce_hex[ucp[i] >> 4];
+        *cp++ = uuid_dce_hex[ucp[i] & 0x0f];
+    }
+    *cp = '\0';
+
+    /* return successfully */
     if (status != NULL)
         *status = uuid_s_ok;
-
-    /* cleanup and return */
-    leave:
-    if (uuid != NULL)
-        uuid_destroy(uuid);
     return;
 }
 
@@ -74,7 +74,9 @@ enum {
     uuid_s_error = 1   /* implementation specific */
 };
 
-/* DCE 1.1 UUID API functions */
+/* DCE 1.1 UUID API functions
+   (uuid_create() uses a generator per thread, which is released when
+   the thread exits; uuid_to_string() returns a malloc(3)'ed string) */
 extern void          uuid_create      (uuid_t *,               int *);
 extern void          uuid_create_nil  (uuid_t *,               int *);
 extern int           uuid_is_nil      (uuid_t *,               int *);
@@ -0,0 +1,168 @@
+/*
+**  OSSP uuid - Universally Unique Identifier
+**  Copyright (c) 2004-2008 Ralf S. Engelschall <rse@engelschall.com>
+**  Copyright (c) 2004-2008 The OSSP Project <http://www.ossp.org/>
+**
+**  This file is part of OSSP uuid, a library for the generation
+**  of UUIDs which can found at http://www.ossp.org/pkg/lib/uuid/
+**
+**  Permission to use, copy, modify, and distribute this software for
+**  any purpose with or without fee is hereby granted, provided that
+**  the above copyright notice and this permission notice appear in all
+**  copies.
+**
+**  THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+**  WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+**  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+**  IN NO EVENT SHALL THE AUTHORS AND COPYRIGHT HOLDERS AND THEIR
+**  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+**  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+**  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+**  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+**  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+**  OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+**  SUCH DAMAGE.
+**
+**  uuid_dce_check.c: self-test of the DCE 1.1 API (for "make check")
+*/
+
+/* own headers */
+#include "uuid_dce.h"
+#include "uuid_ac.h"
+
+/* system headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+/* number of failed checks */
+static int failed = 0;
+
+/* check a single condition */
+#define CHECK(cond) \
+    do { if (!(cond)) { \
+        fprintf(stderr, "uuid_dce_check:FAILED: %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        failed++; \
+    } } while (0)
+
+/* creation, string round-trip and comparison */
+static void
+check_roundtrip(void)
+{
+    uuid_t u1, u2, u3, nil;
+    char *str;
+    int status;
+
+    uuid_create(&u1, &status);
+    CHECK(status == uuid_s_ok);
+    CHECK((u1.data[6] >> 4) == 1);
+    CHECK((u1.data[8] & 0xc0) == 0x80);
+    CHECK(!uuid_is_nil(&u1, &status) && status == uuid_s_ok);
+    uuid_create(&u2, &status);
+    CHECK(status == uuid_s_ok);
+
+    /* to_string returns a malloc(3)'ed string which is parsed back */
+    str = NULL;
+    uuid_to_string(&u1, &str, &status);
+    CHECK(status == uuid_s_ok && str != NULL);
+    if (str != NULL) {
+        CHECK(strlen(str) == 36 && str[8] == '-' && str[23] == '-');
+        uuid_from_string(str, &u3, &status);
+        CHECK(status == uuid_s_ok);
+        CHECK(memcmp(&u1, &u3, sizeof(uuid_t)) == 0);
+        free(str);
+    }
+    uuid_from_string("6ba7b811-9dad-11d1+80b4-00c04fd430c8", &u3, &status);
+    CHECK(status == uuid_s_error);
+
+    /* comparison, equality and hash */
+    CHECK(uuid_compare(&u1, &u1, &status) == 0 && status == uuid_s_ok);
+    CHECK(uuid_compare(&u1, &u2, &status) == -uuid_compare(&u2, &u1, &status));
+    CHECK(uuid_compare(&u1, &u2, &status) != 0);
+    CHECK(uuid_equal(&u1, &u1, &status) && status == uuid_s_ok);
+    CHECK(!uuid_equal(&u1, &u2, &status));
+    u3 = u1;
+    CHECK(uuid_hash(&u1, &status) == uuid_hash(&u3, &status) && status == uuid_s_ok);
+
+    /* Nil UUID */
+    uuid_create_nil(&nil, &status);
+    CHECK(status == uuid_s_ok);
+    CHECK(uuid_is_nil(&nil, &status) && status == uuid_s_ok);
+    CHECK(uuid_compare(&nil, &u1, &status) < 0);
+    return;
+}
+
+#ifdef HAVE_PTHREAD
+/* UUIDs per thread of the multi-threaded check */
+#define THREAD_UUIDS 100
+
+/* thread: create UUIDs with the per-thread generator and exit
+   (which releases the generator again) */
+static void *
+thread_create(void *ctx)
+{
+    uuid_t *u = (uuid_t *)ctx;
+    int i, status;
+
+    for (i = 0; i < THREAD_UUIDS; i++) {
+        uuid_create(&u[i], &status);
+        CHECK(status == uuid_s_ok);
+    }
+    return NULL;
+}
+
+/* qsort(3) callback for UUIDs */
+static int
+cmp_uuid(const void *a, const void *b)
+{
+    return memcmp(a, b, sizeof(uuid_t));
+}
+
+/* UUIDs of concurrent and subsequent threads are unique */
+static void
+check_threads(void)
+{
+    pthread_t tid[8];
+    uuid_t *u;
+    int i, n;
+
+    n = (int)(sizeof(tid)/sizeof(tid[0]));
+    if ((u = (uuid_t *)malloc((size_t)n * 2 * THREAD_UUIDS * sizeof(uuid_t))) == NULL) {
+        CHECK(u != NULL);
+        return;
+    }
+    for (i = 0; i < n; i++)
+        CHECK(pthread_create(&tid[i], NULL, thread_create, &u[i * THREAD_UUIDS]) == 0);
+    for (i = 0; i < n; i++)
+        pthread_join(tid[i], NULL);
+    for (i = 0; i < n; i++) {
+        CHECK(pthread_create(&tid[i], NULL, thread_create, &u[(n + i) * THREAD_UUIDS]) == 0);
+        pthread_join(tid[i], NULL);
+    }
+    qsort(u, (size_t)n * 2 * THREAD_UUIDS, sizeof(uuid_t), cmp_uuid);
+    for (i = 1; i < n * 2 * THREAD_UUIDS; i++)
+        CHECK(memcmp(&u[i-1], &u[i], sizeof(uuid_t)) != 0);
+    free(u);
+    return;
+}
+#endif
+
+/* main procedure */
+int
+main(void)
+{
+    check_roundtrip();
+#ifdef HAVE_PTHREAD
+    check_threads();
+#endif
+    if (failed > 0) {
+        fprintf(stderr, "uuid_dce_check: %d check(s) FAILED\n", failed);
+        return 1;
+    }
+    fprintf(stdout, "DCE 1.1 API: OK\n");
+    return 0;
+}
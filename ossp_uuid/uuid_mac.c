@@ -87,6 +87,7 @@
 
 /* own headers (part (1/2) */
 #include "uuid_mac.h"
+#include "uuid_usdt.h"
 
 #ifndef FALSE
 #define FALSE 0
@@ -95,13 +96,9 @@
 #define TRUE (/*lint -save -e506*/ !FALSE /*lint -restore*/)
 #endif
 
-/* return the Media Access Control (MAC) address of
-   the FIRST network interface card (NIC) */
-int mac_address(unsigned char *data_ptr, size_t data_len)
+/* INTERNAL: platform dependent MAC address lookup */
+static int mac_address_os(unsigned char *data_ptr)
 {
-    /* sanity check arguments */
-    if (data_ptr == NULL || data_len < MAC_LEN)
-        return FALSE;
 
 #ifdef _MSC_VER
     {
@@ -207,3 +204,19 @@ int mac_address(unsigned char *data_ptr, size_t data_len)
     return FALSE;
 }
 
+/* return the Media Access Control (MAC) address of
+   the FIRST network interface card (NIC) */
+int mac_address(unsigned char *data_ptr, size_t data_len)
+{
+    int found;
+
+    /* sanity check arguments */
+    if (data_ptr == NULL || data_len < MAC_LEN)
+        return FALSE;
+
+    UUID_PROBE0(mac__entry);
+    found = mac_address_os(data_ptr);
+    UUID_PROBE1(mac__return, found);
+    return found;
+}
+
@@ -48,8 +48,21 @@
  * - renamed "index" variables to "idx" to avoid namespace conflicts
  * - reformatted C style to conform with OSSP C style
  * - added own OSSP style frontend API
+ * - let MD5Update transform complete blocks directly from the input
+ * - use direct word loads/stores in Decode/Encode on little-endian hosts
+ * - let MD5Final operate on a constant context without extra updates
+ * - use simplified expressions for the F and G functions
  */
 
+/* determine whether the host byte order is little-endian,
+   i.e., equal to the byte order used by MD5 */
+#if   (defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) \
+       && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) \
+    || defined(__i386__) || defined(__x86_64__) \
+    || defined(_M_IX86) || defined(_M_X64) || defined(_M_ARM64)
+#define MD5_LITTLE_ENDIAN
+#endif
+
 /*
 ** ==== BEGIN RFC 1321 CODE ====
 */
@@ -103,22 +116,17 @@ typedef struct {
 
 /* prototypes for internal functions */
 static void MD5Init      (MD5_CTX *_ctx);
-static void MD5Update    (MD5_CTX *_ctx, unsigned char *, unsigned int);
-static void MD5Final     (unsigned char [], MD5_CTX *);
-static void MD5Transform (UINT4 [], unsigned char []);
-static void Encode       (unsigned char *, UINT4 *, unsigned int);
-static void Decode       (UINT4 *, unsigned char *, unsigned int);
-
-/* finalization padding */
-static unsigned char PADDING[64] = {
-  0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
-};
-
-/* F, G, H and I are basic MD5 functions. */
-#define F(x, y, z) (((x) & (y)) | ((~x) & (z)))
-#define G(x, y, z) (((x) & (z)) | ((y) & (~z)))
+static void MD5Update    (MD5_CTX *_ctx, const unsigned char *, unsigned int);
+static void MD5Final     (unsigned char [], const MD5_CTX *);
+static void MD5Transform (UINT4 [], const unsigned char []);
+static void Encode       (unsigned char *, const UINT4 *, unsigned int);
+static void Decode       (UINT4 *, const unsigned char *, unsigned int);
+
+/* F, G, H and I are basic MD5 functions.
+   (F and G are equivalent to the RFC 1321 definitions
+   "(x & y) | (~x & z)" and "(x & z) | (y & ~z)") */
+#define F(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define G(x, y, z) ((y) ^ ((z) & ((x) ^ (y))))
 #define H(x, y, z) ((x) ^ (y) ^ (z))
 #define I(x, y, z) ((y) ^ ((x) | (~z)))
 
@@ -167,7 +175,7 @@ static void MD5Init(
    context. */
 static void MD5Update(
     MD5_CTX *context,                                        /* context */
-    unsigned char *input,                                /* input block */
+    const unsigned char *input,                          /* input block */
     unsigned int inputLen)                     /* length of input block */
 {
     unsigned int i, idx, partLen;
@@ -182,52 +190,59 @@ static void MD5Update(
 
     partLen = (unsigned int)64 - idx;
 
-    /* Transform as many times as possible.  */
-    if (inputLen >= partLen) {
-        memcpy((POINTER)&context->buffer[idx], (POINTER)input, (size_t)partLen);
+    /* Transform as many times as possible, directly from the input
+       if no partial block is pending. */
+    i = 0;
+    if (idx > 0 && inputLen >= partLen) {
+        memcpy((POINTER)&context->buffer[idx], input, (size_t)partLen);
         MD5Transform(context->state, context->buffer);
-        for (i = partLen; i + 63 < inputLen; i += 64)
-            MD5Transform(context->state, &input[i]);
+        i = partLen;
         idx = 0;
     }
-    else
-        i = 0;
+    if (idx == 0) {
+        for (; i + 63 < inputLen; i += 64)
+            MD5Transform(context->state, &input[i]);
+    }
 
     /* Buffer remaining input */
-    memcpy((POINTER)&context->buffer[idx], (POINTER)&input[i], (size_t)(inputLen - i));
+    memcpy((POINTER)&context->buffer[idx], &input[i], (size_t)(inputLen - i));
 }
 
 /* MD5 finalization. Ends an MD5 message-digest operation, writing the
-   the message digest and zeroizing the context. */
+   the message digest. The context itself is left untouched, so the
+   operation can be continued afterwards. */
 static void MD5Final(
     unsigned char digest[],                                 /* message digest */
-    MD5_CTX *context)                                       /* context */
+    const MD5_CTX *context)                                 /* context */
 {
-    unsigned char bits[8];
+    UINT4 state[4];
+    unsigned char block[128];
     unsigned int idx, padLen;
 
-    /* Save number of bits */
-    Encode(bits, context->count, 8);
-
-    /* Pad out to 56 mod 64. */
+    /* Copy pending input and append the padding bit */
     idx = (unsigned int)((context->count[0] >> 3) & 0x3f);
-    padLen = (idx < 56) ? ((unsigned int)56 - idx) : ((unsigned int)120 - idx);
-    MD5Update(context, PADDING, padLen);
+    memcpy(block, context->buffer, (size_t)idx);
+    block[idx++] = 0x80;
 
-    /* Append length (before padding) */
-    MD5Update(context, bits, 8);
+    /* Pad out to 56 mod 64 and append length (before padding) */
+    padLen = (idx <= 56) ? 64 : 128;
+    memset(&block[idx], 0, (size_t)(padLen - 8 - idx));
+    Encode(&block[padLen - 8], context->count, 8);
 
-    /* Store state in digest */
-    Encode(digest, context->state, 16);
+    /* Transform the final block(s) */
+    memcpy(state, context->state, sizeof(state));
+    MD5Transform(state, block);
+    if (padLen > 64)
+        MD5Transform(state, &block[64]);
 
-    /* Zeroize sensitive information. */
-    memset((POINTER)context, 0, sizeof(*context));
+    /* Store state in digest */
+    Encode(digest, state, 16);
 }
 
 /* MD5 basic transformation. Transforms state based on block. */
 static void MD5Transform(
     UINT4 state[],
-    unsigned char block[])
+    const unsigned char block[])
 {
     UINT4 a = state[0], b = state[1], c = state[2], d = state[3], x[16];
 
@@ -325,18 +340,18 @@ static void MD5Transform(
     state[1] += b;
     state[2] += c;
     state[3] += d;
-
-    /* Zeroize sensitive information. */
-    memset((POINTER)x, 0, sizeof(x));
 }
 
 /* Encodes input (UINT4) into output (unsigned char).
    Assumes len is a multiple of 4. */
 static void Encode(
     unsigned char *output,
-    UINT4 *input,
+    const UINT4 *input,
     unsigned int len)
 {
+#ifdef MD5_LITTLE_ENDIAN
+    memcpy(output, input, (size_t)len);
+#else
     unsigned int i, j;
 
     for (i = 0, j = 0; j < len; i++, j += 4) {
@@ -345,6 +360,7 @@ static void Encode(
         output[j+2] = (unsigned char)((input[i] >> 16) & 0xff);
         output[j+3] = (unsigned char)((input[i] >> 24) & 0xff);
     }
+#endif
     return;
 }
 
@@ -352,9 +368,12 @@ static void Encode(
    Assumes len is a multiple of 4. */
 static void Decode(
     UINT4 *output,
-    unsigned char *input,
+    const unsigned char *input,
     unsigned int len)
 {
+#ifdef MD5_LITTLE_ENDIAN
+    memcpy(output, input, (size_t)len);
+#else
     unsigned int i, j;
 
     for (i = 0, j = 0; j < len; i++, j += 4)
@@ -362,6 +381,7 @@ static void Decode(
                     | (((UINT4)input[j+1]) << 8 )
                     | (((UINT4)input[j+2]) << 16)
                     | (((UINT4)input[j+3]) << 24);
+#endif
     return;
 }
 
@@ -395,14 +415,12 @@ md5_rc_t md5_update(md5_t *md5, const void *data_ptr, size_t data_len)
 {
     if (md5 == NULL)
         return MD5_RC_ARG;
-    MD5Update(&(md5->ctx), (unsigned char *)data_ptr, (unsigned int)data_len);
+    MD5Update(&(md5->ctx), (const unsigned char *)data_ptr, (unsigned int)data_len);
     return MD5_RC_OK;
 }
 
 md5_rc_t md5_store(md5_t *md5, void **data_ptr, size_t *data_len)
 {
-    MD5_CTX ctx;
-
     if (md5 == NULL || data_ptr == NULL)
         return MD5_RC_ARG;
     if (*data_ptr == NULL) {
@@ -418,8 +436,7 @@ md5_rc_t md5_store(md5_t *md5, void **data_ptr, size_t *data_len)
             *data_len = MD5_LEN_BIN;
         }
     }
-    memcpy((void *)(&ctx), (void *)(&(md5->ctx)), sizeof(MD5_CTX));
-    MD5Final((unsigned char *)(*data_ptr), &(ctx));
+    MD5Final((unsigned char *)(*data_ptr), &(md5->ctx));
     return MD5_RC_OK;
 }
 
@@ -44,6 +44,7 @@
 
 /* required system headers */
 #include <string.h>
+#include <stdint.h>
 
 /* minimum C++ support */
 #ifdef __cplusplus
@@ -63,6 +64,10 @@ DECLARATION_BEGIN
 #define UUID_LEN_BIN  (128 /*bit*/ / 8 /*bytes*/)
 #define UUID_LEN_STR  (128 /*bit*/ / 4 /*nibbles*/ + 4 /*hyphens*/)
 #define UUID_LEN_SIV  (39  /*int(log(10,exp(2,128)-1)+1) digits*/)
+#define UUID_LEN_B64  (22  /*ceil(128/6) base64url characters*/)
+#define UUID_LEN_B32  (26  /*ceil(128/5) base32 characters*/)
+#define UUID_LEN_B58  (22  /*ceil(128/log(2,58)) base58 characters*/)
+#define UUID_LEN_ULID (26  /*ceil(128/5) base32 characters*/)
 
 /* API return codes */
 typedef enum {
@@ -76,25 +81,69 @@ typedef enum {
 
 /* UUID make modes */
 enum {
-    UUID_MAKE_V1 = (1 << 0), /* DCE 1.1 v1 UUID */
-    UUID_MAKE_V3 = (1 << 1), /* DCE 1.1 v3 UUID */
-    UUID_MAKE_V4 = (1 << 2), /* DCE 1.1 v4 UUID */
-    UUID_MAKE_V5 = (1 << 3), /* DCE 1.1 v5 UUID */
-    UUID_MAKE_MC = (1 << 4)  /* enforce multi-cast MAC address */
+    UUID_MAKE_V1   = (1 << 0), /* DCE 1.1 v1 UUID */
+    UUID_MAKE_V3   = (1 << 1), /* DCE 1.1 v3 UUID */
+    UUID_MAKE_V4   = (1 << 2), /* DCE 1.1 v4 UUID */
+    UUID_MAKE_V5   = (1 << 3), /* DCE 1.1 v5 UUID */
+    UUID_MAKE_MC   = (1 << 4), /* enforce multi-cast MAC address */
+    UUID_MAKE_V7   = (1 << 5), /* RFC 9562 v7 UUID */
+    UUID_MAKE_ULID = (1 << 6)  /* monotonic ULID */
 };
 
 /* UUID import/export formats */
 typedef enum {
-    UUID_FMT_BIN = 0,        /* binary representation (import/export) */
-    UUID_FMT_STR = 1,        /* string representation (import/export) */
-    UUID_FMT_SIV = 2,        /* single integer value  (import/export) */
-    UUID_FMT_TXT = 3         /* textual description   (export only)   */
+    UUID_FMT_BIN  = 0,       /* binary representation (import/export) */
+    UUID_FMT_STR  = 1,       /* string representation (import/export) */
+    UUID_FMT_SIV  = 2,       /* single integer value  (import/export) */
+    UUID_FMT_TXT  = 3,       /* textual description   (export only)   */
+    UUID_FMT_B64  = 4,       /* base64url             (import/export) */
+    UUID_FMT_B32  = 5,       /* Crockford base32      (import/export) */
+    UUID_FMT_B58  = 6,       /* base58                (import/export) */
+    UUID_FMT_ULID = 7        /* ULID                  (import/export) */
 } uuid_fmt_t;
 
 /* UUID abstract data type */
 struct uuid_st;
 typedef struct uuid_st uuid_t;
 
+/* UUID generator statistics (event counters since library load) */
+typedef struct {
+    unsigned long make;           /* uuid_make() calls                     */
+    unsigned long v1_stalls;      /* v1: waits for the system clock        */
+    unsigned long v1_backsteps;   /* v1: clock went backwards (new clock sequence) */
+    unsigned long v7_clamps;      /* v7: clock did not advance (timestamp incremented) */
+    unsigned long ulid_increments;/* ULID: same millisecond (random part incremented) */
+    unsigned long prng_dev_reads; /* system PRNG device reads              */
+    unsigned long prng_dev_bytes; /* bytes read from system PRNG device    */
+    unsigned long prng_dev_errors;/* failed system PRNG device reads       */
+    unsigned long prng_fallbacks; /* PRNG requests served by libc/MD5 PRNG */
+    unsigned long prng_fallback_bytes; /* bytes generated by libc/MD5 PRNG */
+} uuid_stats_t;
+
+/* UUID variants (as decoded) */
+#define UUID_VARIANT_NCS    0    /* reserved (NCS backward compatible)  */
+#define UUID_VARIANT_DCE    1    /* DCE 1.1, ISO/IEC 11578:1996         */
+#define UUID_VARIANT_MS     2    /* reserved (Microsoft GUID)           */
+#define UUID_VARIANT_FUTURE 3    /* reserved (future use)               */
+
+/* UUID decoding flags */
+#define UUID_DEC_NIL       (1 << 0)  /* Nil UUID                                */
+#define UUID_DEC_TIME      (1 << 1)  /* "time" and "time_unix" are valid        */
+#define UUID_DEC_NODE      (1 << 2)  /* "clock_seq" and "node" are valid        */
+#define UUID_DEC_LOCAL     (1 << 3)  /* node is a locally administered address  */
+#define UUID_DEC_MULTICAST (1 << 4)  /* node is a multicast (i.e. random) address */
+
+/* UUID fields (decoded) */
+typedef struct {
+    unsigned int  version;   /* version number (DCE 1.1 variant only, else 0)     */
+    unsigned int  variant;   /* variant (UUID_VARIANT_XXX)                        */
+    unsigned int  flags;     /* decoding flags (UUID_DEC_XXX)                     */
+    uint64_t      time;      /* v1/v6/v7: 100ns ticks since 1582-10-15 00:00 UTC  */
+    int64_t       time_unix; /* v1/v6/v7: nanoseconds since 1970-01-01 00:00 UTC (saturated) */
+    unsigned int  clock_seq; /* v1/v6: 14 bit clock sequence                      */
+    unsigned char node[6];   /* v1/v6: IEEE 802 node address                      */
+} uuid_fields_t;
+
 /* UUID object handling */
 extern uuid_rc_t     uuid_create   (      uuid_t **_uuid);
 extern uuid_rc_t     uuid_destroy  (      uuid_t  *_uuid);
@@ -112,9 +161,14 @@ extern uuid_rc_t     uuid_compare  (const uuid_t  *_uuid, const uuid_t *_uuid2,
 extern uuid_rc_t     uuid_import   (      uuid_t  *_uuid, uuid_fmt_t _fmt, const void  *_data_ptr, size_t  _data_len);
 extern uuid_rc_t     uuid_export   (const uuid_t  *_uuid, uuid_fmt_t _fmt,       void  *_data_ptr, size_t *_data_len);
 
+/* UUID decoding */
+extern uuid_rc_t     uuid_decode    (const uuid_t *_uuid, uuid_fields_t *_fields);
+extern uuid_rc_t     uuid_decode_bin(const void *_data_ptr, size_t _count, uuid_fields_t *_fields);
+
 /* library utilities */
 extern char         *uuid_error    (uuid_rc_t _rc);
 extern unsigned long uuid_version  (void);
+extern uuid_rc_t     uuid_stats    (      uuid_t  *_uuid, uuid_stats_t *_stats);
 
 DECLARATION_END
 
@@ -61,11 +61,13 @@ static void close(int d) { return; }
 #include "uuid_time.h"
 #include "uuid_prng.h"
 #include "uuid_md5.h"
+#include "uuid_usdt.h"
 
 struct prng_st {
     int    dev; /* system PRNG device */
     md5_t *md5; /* local MD5 PRNG engine */
     long   cnt; /* time resolution compensation counter */
+    prng_stats_t stats; /* event counters since last prng_stats() */
 };
 
 prng_rc_t prng_create(prng_t **prng)
@@ -105,6 +107,9 @@ prng_rc_t prng_create(prng_t **prng)
     /* initialize time resolution compensation counter */
     (*prng)->cnt = 0;
 
+    /* initialize event counters */
+    memset(&(*prng)->stats, 0, sizeof((*prng)->stats));
+
     /* seed the C library PRNG once */
     (void)time_gettimeofday(&tv);
 #ifdef _MSC_VER
@@ -151,18 +156,24 @@ prng_rc_t prng_data(prng_t *prng, void *data_ptr, size_t data_len)
 
     /* approach 1: try to gather data via stronger system PRNG device */
     if (prng->dev != -1) {
+        UUID_PROBE1(prng__read__entry, n);
         retries = 0;
         while (n > 0) {
             i = (int)read(prng->dev, (void *)p, n);
             if (i <= 0) {
+                prng->stats.dev_errors++;
+                UUID_PROBE1(prng__read__error, retries);
                 if (retries++ > 16)
                     break;
                 continue;
             }
+            prng->stats.dev_reads++;
+            prng->stats.dev_bytes += (unsigned long)i;
             retries = 0;
             n -= (unsigned int)i;
             p += (unsigned int)i;
         }
+        UUID_PROBE2(prng__read__return, data_len - n, retries);
     }
 #if defined(WIN32)
     else {
@@ -172,6 +183,11 @@ prng_rc_t prng_data(prng_t *prng, void *data_ptr, size_t data_len)
 #endif
 
     /* approach 2: try to gather data via weaker libc PRNG API. */
+    if (n > 0) {
+        prng->stats.fallbacks++;
+        prng->stats.fallback_bytes += (unsigned long)n;
+        UUID_PROBE1(prng__fallback, n);
+    }
     while (n > 0) {
         /* gather new entropy */
         (void)time_gettimeofday(&(entropy.tv));  /* source: libc time */
@@ -195,6 +211,19 @@ prng_rc_t prng_data(prng_t *prng, void *data_ptr, size_t data_len)
     return PRNG_RC_OK;
 }
 
+prng_rc_t prng_stats(prng_t *prng, prng_stats_t *stats)
+{
+    /* sanity check argument(s) */
+    if (prng == NULL || stats == NULL)
+        return PRNG_RC_ARG;
+
+    /* hand out and reset event counters */
+    *stats = prng->stats;
+    memset(&prng->stats, 0, sizeof(prng->stats));
+
+    return PRNG_RC_OK;
+}
+
 prng_rc_t prng_destroy(prng_t *prng)
 {
     /* sanity check argument(s) */
@@ -48,6 +48,8 @@
 #define prng_create  PRNG_CONCAT(PRNG_PREFIX,prng_create)
 #define prng_data    PRNG_CONCAT(PRNG_PREFIX,prng_data)
 #define prng_destroy PRNG_CONCAT(PRNG_PREFIX,prng_destroy)
+#define prng_stats   PRNG_CONCAT(PRNG_PREFIX,prng_stats)
+#define prng_stats_t PRNG_CONCAT(PRNG_PREFIX,prng_stats_t)
 #endif
 
 struct prng_st;
@@ -60,9 +62,18 @@ typedef enum {
     PRNG_RC_INT = 3
 } prng_rc_t;
 
+typedef struct {
+    unsigned long dev_reads;      /* successful system PRNG device reads */
+    unsigned long dev_bytes;      /* bytes read from system PRNG device */
+    unsigned long dev_errors;     /* failed system PRNG device reads */
+    unsigned long fallbacks;      /* calls which used the libc/MD5 PRNG */
+    unsigned long fallback_bytes; /* bytes generated by the libc/MD5 PRNG */
+} prng_stats_t;
+
 extern prng_rc_t prng_create  (prng_t **prng);
 extern prng_rc_t prng_data    (prng_t  *prng, void *data_ptr, size_t data_len);
 extern prng_rc_t prng_destroy (prng_t  *prng);
+extern prng_rc_t prng_stats   (prng_t  *prng, prng_stats_t *stats);
 
 #endif /* __PRNG_H___ */
 
@@ -34,6 +34,27 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* determine availability of hardware accelerated SHA-1 compression
+   (can be disabled at build-time with -DSHA1_NO_HWACCEL) */
+#if !defined(SHA1_NO_HWACCEL) && (defined(__x86_64__) || defined(__i386__)) \
+    && (   (defined(__clang__) && __clang_major__ >= 4) \
+        || (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 5))
+#define SHA1_HWACCEL_X86
+#define SHA1_TARGET_X86 __attribute__((target("sse4.1,sha")))
+#include <cpuid.h>
+#include <immintrin.h>
+#elif !defined(SHA1_NO_HWACCEL) && (defined(_M_X64) || defined(_M_IX86)) \
+    && defined(_MSC_VER) && _MSC_VER >= 1900
+#define SHA1_HWACCEL_X86
+#define SHA1_TARGET_X86
+#include <intrin.h>
+#include <immintrin.h>
+#elif !defined(SHA1_NO_HWACCEL) && defined(__aarch64__) \
+    && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#define SHA1_HWACCEL_ARM
+#include <arm_neon.h>
+#endif
+
 /* own headers (part 2/2) */
 #include "uuid_sha1.h"
 
@@ -45,6 +66,11 @@
  *  - reformatted C style to conform with OSSP C style
  *  - added own OSSP style frontend API
  *  - added Autoconf based determination of sha1_uintX_t types
+ *  - process complete 512-bit blocks directly from the input and
+ *    use a rolling 16-word message schedule in the compression
+ *  - added hardware accelerated compression functions (Intel SHA
+ *    extensions and ARMv8 Cryptography Extensions), selected at
+ *    run-time via CPU feature detection
  */
 
 /*
@@ -121,6 +147,22 @@ static int SHA1Result (SHA1Context *, sha1_uint8_t Message_Digest[]);
 static void SHA1PadMessage         (SHA1Context *);
 static void SHA1ProcessMessageBlock(SHA1Context *);
 
+/* Compression Function Prototypes
+   (all process "blocks" consecutive 512-bit blocks at "data") */
+typedef void (*SHA1CompressFunc)(sha1_uint32_t *, const sha1_uint8_t *, size_t);
+static void SHA1CompressGeneric (sha1_uint32_t *, const sha1_uint8_t *, size_t);
+#ifdef SHA1_HWACCEL_X86
+static void SHA1CompressX86     (sha1_uint32_t *, const sha1_uint8_t *, size_t);
+#endif
+#ifdef SHA1_HWACCEL_ARM
+static void SHA1CompressARM     (sha1_uint32_t *, const sha1_uint8_t *, size_t);
+#endif
+static void SHA1CompressDispatch(sha1_uint32_t *, const sha1_uint8_t *, size_t);
+
+/* Compression Function currently in use
+   (resolved on first use by SHA1CompressDispatch) */
+static SHA1CompressFunc SHA1Compress = SHA1CompressDispatch;
+
 /* Define the SHA1 circular left shift macro */
 #define SHA1CircularShift(bits,word) \
     (((word) << (bits)) | ((word) >> (32-(bits))))
@@ -187,6 +229,10 @@ static int SHA1Result(SHA1Context *context, sha1_uint8_t Message_Digest[])
  */
 static int SHA1Input(SHA1Context *context, const sha1_uint8_t *message_array, unsigned int length)
 {
+    sha1_uint32_t bits_low;
+    sha1_uint32_t bits_high;
+    unsigned int n;
+
     if (length == 0)
         return shaSuccess;
     if (context == NULL || message_array == NULL)
@@ -198,17 +244,45 @@ static int SHA1Input(SHA1Context *context, const sha1_uint8_t *message_array, un
     }
     if (context->Corrupted)
         return context->Corrupted;
-    while (length-- && !context->Corrupted) {
-        context->Message_Block[context->Message_Block_Index++] = (*message_array & 0xFF);
-        context->Length_Low += 8;
-        if (context->Length_Low == 0) {
-            context->Length_High++;
-            if (context->Length_High == 0)
-                context->Corrupted = 1; /* Message is too long */
-        }
-        if (context->Message_Block_Index == 64)
-            SHA1ProcessMessageBlock(context);
-        message_array++;
+
+    /* account for the message length in bits */
+    bits_low  = (sha1_uint32_t)length << 3;
+    bits_high = (sha1_uint32_t)length >> 29;
+    context->Length_Low += bits_low;
+    if (context->Length_Low < bits_low)
+        bits_high++;
+    context->Length_High += bits_high;
+    if (context->Length_High < bits_high) {
+        context->Corrupted = 1; /* Message is too long */
+        return context->Corrupted;
+    }
+
+    /* complete a partially filled message block */
+    if (context->Message_Block_Index > 0) {
+        n = 64 - (unsigned int)context->Message_Block_Index;
+        if (n > length)
+            n = length;
+        memcpy(&context->Message_Block[context->Message_Block_Index], message_array, n);
+        context->Message_Block_Index += (sha1_int16plus_t)n;
+        message_array += n;
+        length        -= n;
+        if (context->Message_Block_Index < 64)
+            return shaSuccess;
+        SHA1ProcessMessageBlock(context);
+    }
+
+    /* process all complete message blocks in-place */
+    if (length >= 64) {
+        n = length / 64;
+        SHA1Compress(context->Intermediate_Hash, message_array, (size_t)n);
+        message_array += n * 64;
+        length        -= n * 64;
+    }
+
+    /* buffer the remaining octets */
+    if (length > 0) {
+        memcpy(context->Message_Block, message_array, length);
+        context->Message_Block_Index = (sha1_int16plus_t)length;
     }
 
     return shaSuccess;
@@ -216,11 +290,23 @@ static int SHA1Input(SHA1Context *context, const sha1_uint8_t *message_array, un
 
 /*
  *  This function will process the next 512 bits of the message stored
- *  in the Message_Block array. NOTICE: Many of the variable names in
- *  this code, especially the single character names, were used because
- *  those were the names used in the publication.
+ *  in the Message_Block array.
  */
 static void SHA1ProcessMessageBlock(SHA1Context *context)
+{
+    SHA1Compress(context->Intermediate_Hash, context->Message_Block, 1);
+    context->Message_Block_Index = 0;
+    return;
+}
+
+/*
+ *  This function will process consecutive 512-bit blocks of the message
+ *  with plain C code. NOTICE: Many of the variable names in this code,
+ *  especially the single character names, were used because those were
+ *  the names used in the publication. The word sequence is computed on
+ *  the fly in a rolling window of 16 words instead of 80 words.
+ */
+static void SHA1CompressGeneric(sha1_uint32_t *H, const sha1_uint8_t *data, size_t blocks)
 {
     const sha1_uint32_t K[] = {   /* Constants defined in SHA-1   */
         0x5A827999,
@@ -230,70 +316,275 @@ static void SHA1ProcessMessageBlock(SHA1Context *context)
     };
     int            t;             /* Loop counter                */
     sha1_uint32_t  temp;          /* Temporary word value        */
-    sha1_uint32_t  W[80];         /* Word sequence               */
+    sha1_uint32_t  W[16];         /* Word sequence window        */
     sha1_uint32_t  A, B, C, D, E; /* Word buffers                */
 
-    /* Initialize the first 16 words in the array W */
-    for (t = 0; t < 16; t++) {
-        W[t]  = (sha1_uint32_t)(context->Message_Block[t * 4    ] << 24);
-        W[t] |= (sha1_uint32_t)(context->Message_Block[t * 4 + 1] << 16);
-        W[t] |= (sha1_uint32_t)(context->Message_Block[t * 4 + 2] <<  8);
-        W[t] |= (sha1_uint32_t)(context->Message_Block[t * 4 + 3]      );
-    }
+#define SHA1Schedule(t) \
+    (W[(t) & 15] = SHA1CircularShift(1, W[((t) + 13) & 15] ^ W[((t) + 8) & 15] \
+                                      ^ W[((t) +  2) & 15] ^ W[(t) & 15]))
+#define SHA1Round(f, k, w) \
+    do { \
+        temp = SHA1CircularShift(5, A) + (f) + E + (w) + (k); \
+        E = D; \
+        D = C; \
+        C = SHA1CircularShift(30, B); \
+        B = A; \
+        A = temp; \
+    } while (0)
+
+    while (blocks-- > 0) {
+        /* Initialize the first 16 words in the array W */
+        for (t = 0; t < 16; t++) {
+            W[t] = ((sha1_uint32_t)data[t * 4    ] << 24)
+                 | ((sha1_uint32_t)data[t * 4 + 1] << 16)
+                 | ((sha1_uint32_t)data[t * 4 + 2] <<  8)
+                 | ((sha1_uint32_t)data[t * 4 + 3]      );
+        }
 
-    for (t = 16; t < 80; t++)
-       W[t] = SHA1CircularShift(1, W[t-3] ^ W[t-8] ^ W[t-14] ^ W[t-16]);
-
-    A = context->Intermediate_Hash[0];
-    B = context->Intermediate_Hash[1];
-    C = context->Intermediate_Hash[2];
-    D = context->Intermediate_Hash[3];
-    E = context->Intermediate_Hash[4];
-
-    for (t = 0; t < 20; t++) {
-        temp =  SHA1CircularShift(5, A) + ((B & C) | ((~B) & D)) + E + W[t] + K[0];
-        E = D;
-        D = C;
-        C = SHA1CircularShift(30, B);
-        B = A;
-        A = temp;
+        A = H[0];
+        B = H[1];
+        C = H[2];
+        D = H[3];
+        E = H[4];
+
+        for (t = 0; t < 16; t++)
+            SHA1Round((B & C) | ((~B) & D), K[0], W[t]);
+        for (t = 16; t < 20; t++)
+            SHA1Round((B & C) | ((~B) & D), K[0], SHA1Schedule(t));
+        for (t = 20; t < 40; t++)
+            SHA1Round(B ^ C ^ D, K[1], SHA1Schedule(t));
+        for (t = 40; t < 60; t++)
+            SHA1Round((B & C) | (B & D) | (C & D), K[2], SHA1Schedule(t));
+        for (t = 60; t < 80; t++)
+            SHA1Round(B ^ C ^ D, K[3], SHA1Schedule(t));
+
+        H[0] += A;
+        H[1] += B;
+        H[2] += C;
+        H[3] += D;
+        H[4] += E;
+
+        data += 64;
     }
 
-    for (t = 20; t < 40; t++) {
-        temp = SHA1CircularShift(5, A) + (B ^ C ^ D) + E + W[t] + K[1];
-        E = D;
-        D = C;
-        C = SHA1CircularShift(30, B);
-        B = A;
-        A = temp;
-    }
+#undef SHA1Schedule
+#undef SHA1Round
+    return;
+}
 
-    for (t = 40; t < 60; t++) {
-        temp = SHA1CircularShift(5, A) + ((B & C) | (B & D) | (C & D)) + E + W[t] + K[2];
-        E = D;
-        D = C;
-        C = SHA1CircularShift(30, B);
-        B = A;
-        A = temp;
+#ifdef SHA1_HWACCEL_X86
+/*
+ *  This function will process consecutive 512-bit blocks of the message
+ *  with the Intel SHA extensions. Each SHA1RNDS4 instruction performs
+ *  four rounds, the SHA1MSG1/SHA1MSG2 instructions compute the next four
+ *  words of the word sequence and SHA1NEXTE derives the E word of the
+ *  next four rounds.
+ */
+SHA1_TARGET_X86
+static void SHA1CompressX86(sha1_uint32_t *H, const sha1_uint8_t *data, size_t blocks)
+{
+    __m128i ABCD, ABCD_SAVE, E0, E0_SAVE, E1;
+    __m128i MSG0, MSG1, MSG2, MSG3;
+    const __m128i MASK = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+
+    /* load state in the lane order required by the instructions */
+    ABCD = _mm_loadu_si128((const __m128i *)H);
+    ABCD = _mm_shuffle_epi32(ABCD, 0x1B);
+    E0   = _mm_set_epi32((int)H[4], 0, 0, 0);
+
+    while (blocks-- > 0) {
+        ABCD_SAVE = ABCD;
+        E0_SAVE   = E0;
+
+        /* rounds 0-3 */
+        MSG0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data +  0)), MASK);
+        E0   = _mm_add_epi32(E0, MSG0);
+        E1   = ABCD;
+        ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+
+        /* rounds 4-7 */
+        MSG1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16)), MASK);
+        E1   = _mm_sha1nexte_epu32(E1, MSG1);
+        E0   = ABCD;
+        ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 0);
+        MSG0 = _mm_sha1msg1_epu32(MSG0, MSG1);
+
+        /* rounds 8-11 */
+        MSG2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 32)), MASK);
+        E0   = _mm_sha1nexte_epu32(E0, MSG2);
+        E1   = ABCD;
+        ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+        MSG1 = _mm_sha1msg1_epu32(MSG1, MSG2);
+        MSG0 = _mm_xor_si128(MSG0, MSG2);
+
+        /* rounds 12-15 */
+        MSG3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 48)), MASK);
+        E1   = _mm_sha1nexte_epu32(E1, MSG3);
+        E0   = ABCD;
+        MSG0 = _mm_sha1msg2_epu32(MSG0, MSG3);
+        ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 0);
+        MSG2 = _mm_sha1msg1_epu32(MSG2, MSG3);
+        MSG1 = _mm_xor_si128(MSG1, MSG3);
+
+        /* rounds 16-63: steady state of the message schedule
+           (Ea/Eb alternate, Mn is the current word group, Mi is the
+           group being finished, Mx the one being extended and Mp
+           the one being prepared for later use) */
+#define SHA1_X86_ROUNDS(Ea, Eb, Mn, Mi, Mx, Mp, f) \
+        Ea   = _mm_sha1nexte_epu32(Ea, Mn); \
+        Eb   = ABCD; \
+        Mi   = _mm_sha1msg2_epu32(Mi, Mn); \
+        ABCD = _mm_sha1rnds4_epu32(ABCD, Ea, f); \
+        Mp   = _mm_sha1msg1_epu32(Mp, Mn); \
+        Mx   = _mm_xor_si128(Mx, Mn)
+        SHA1_X86_ROUNDS(E0, E1, MSG0, MSG1, MSG2, MSG3, 0); /* 16-19 */
+        SHA1_X86_ROUNDS(E1, E0, MSG1, MSG2, MSG3, MSG0, 1); /* 20-23 */
+        SHA1_X86_ROUNDS(E0, E1, MSG2, MSG3, MSG0, MSG1, 1); /* 24-27 */
+        SHA1_X86_ROUNDS(E1, E0, MSG3, MSG0, MSG1, MSG2, 1); /* 28-31 */
+        SHA1_X86_ROUNDS(E0, E1, MSG0, MSG1, MSG2, MSG3, 1); /* 32-35 */
+        SHA1_X86_ROUNDS(E1, E0, MSG1, MSG2, MSG3, MSG0, 1); /* 36-39 */
+        SHA1_X86_ROUNDS(E0, E1, MSG2, MSG3, MSG0, MSG1, 2); /* 40-43 */
+        SHA1_X86_ROUNDS(E1, E0, MSG3, MSG0, MSG1, MSG2, 2); /* 44-47 */
+        SHA1_X86_ROUNDS(E0, E1, MSG0, MSG1, MSG2, MSG3, 2); /* 48-51 */
+        SHA1_X86_ROUNDS(E1, E0, MSG1, MSG2, MSG3, MSG0, 2); /* 52-55 */
+        SHA1_X86_ROUNDS(E0, E1, MSG2, MSG3, MSG0, MSG1, 2); /* 56-59 */
+        SHA1_X86_ROUNDS(E1, E0, MSG3, MSG0, MSG1, MSG2, 3); /* 60-63 */
+        SHA1_X86_ROUNDS(E0, E1, MSG0, MSG1, MSG2, MSG3, 3); /* 64-67 */
+#undef SHA1_X86_ROUNDS
+
+        /* rounds 68-71 */
+        E1   = _mm_sha1nexte_epu32(E1, MSG1);
+        E0   = ABCD;
+        MSG2 = _mm_sha1msg2_epu32(MSG2, MSG1);
+        ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 3);
+        MSG3 = _mm_xor_si128(MSG3, MSG1);
+
+        /* rounds 72-75 */
+        E0   = _mm_sha1nexte_epu32(E0, MSG2);
+        E1   = ABCD;
+        MSG3 = _mm_sha1msg2_epu32(MSG3, MSG2);
+        ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 3);
+
+        /* rounds 76-79 */
+        E1   = _mm_sha1nexte_epu32(E1, MSG3);
+        E0   = ABCD;
+        ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 3);
+
+        /* combine state */
+        E0   = _mm_sha1nexte_epu32(E0, E0_SAVE);
+        ABCD = _mm_add_epi32(ABCD, ABCD_SAVE);
+
+        data += 64;
     }
 
-    for (t = 60; t < 80; t++) {
-        temp = SHA1CircularShift(5, A) + (B ^ C ^ D) + E + W[t] + K[3];
-        E = D;
-        D = C;
-        C = SHA1CircularShift(30, B);
-        B = A;
-        A = temp;
+    /* store state back in natural word order */
+    ABCD = _mm_shuffle_epi32(ABCD, 0x1B);
+    _mm_storeu_si128((__m128i *)H, ABCD);
+    H[4] = (sha1_uint32_t)_mm_extract_epi32(E0, 3);
+    return;
+}
+#endif /* SHA1_HWACCEL_X86 */
+
+#ifdef SHA1_HWACCEL_ARM
+/*
+ *  This function will process consecutive 512-bit blocks of the message
+ *  with the ARMv8 Cryptography Extensions. Each SHA1C/SHA1P/SHA1M
+ *  instruction performs four rounds, the SHA1SU0/SHA1SU1 instructions
+ *  compute the next four words of the word sequence.
+ */
+static void SHA1CompressARM(sha1_uint32_t *H, const sha1_uint8_t *data, size_t blocks)
+{
+    static const sha1_uint32_t K[] = {
+        0x5A827999,
+        0x6ED9EBA1,
+        0x8F1BBCDC,
+        0xCA62C1D6
+    };
+    uint32x4_t ABCD, ABCD_SAVE, TMP;
+    uint32x4_t MSG[4];
+    uint32_t E0, E0_SAVE, E1;
+    int t;
+
+    ABCD = vld1q_u32((const uint32_t *)H);
+    E0   = (uint32_t)H[4];
+
+    while (blocks-- > 0) {
+        ABCD_SAVE = ABCD;
+        E0_SAVE   = E0;
+
+        for (t = 0; t < 4; t++)
+            MSG[t] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + t * 16)));
+
+        for (t = 0; t < 20; t++) {
+            if (t >= 4)
+                MSG[t & 3] = vsha1su1q_u32(vsha1su0q_u32(MSG[t & 3], MSG[(t + 1) & 3],
+                                                         MSG[(t + 2) & 3]), MSG[(t + 3) & 3]);
+            TMP = vaddq_u32(MSG[t & 3], vdupq_n_u32(K[t / 5]));
+            E1  = vsha1h_u32(vgetq_lane_u32(ABCD, 0));
+            if (t < 5)
+                ABCD = vsha1cq_u32(ABCD, E0, TMP);
+            else if (t >= 10 && t < 15)
+                ABCD = vsha1mq_u32(ABCD, E0, TMP);
+            else
+                ABCD = vsha1pq_u32(ABCD, E0, TMP);
+            E0 = E1;
+        }
+
+        ABCD = vaddq_u32(ABCD, ABCD_SAVE);
+        E0  += E0_SAVE;
+
+        data += 64;
     }
 
-    context->Intermediate_Hash[0] += A;
-    context->Intermediate_Hash[1] += B;
-    context->Intermediate_Hash[2] += C;
-    context->Intermediate_Hash[3] += D;
-    context->Intermediate_Hash[4] += E;
+    vst1q_u32((uint32_t *)H, ABCD);
+    H[4] = (sha1_uint32_t)E0;
+    return;
+}
+#endif /* SHA1_HWACCEL_ARM */
 
-    context->Message_Block_Index = 0;
+/*
+ *  This function will determine the best compression function for the
+ *  current CPU on first use, remember it and then forward to it. Races
+ *  between threads are harmless as all of them store the same result.
+ */
+static void SHA1CompressDispatch(sha1_uint32_t *H, const sha1_uint8_t *data, size_t blocks)
+{
+    SHA1CompressFunc func;
+#if defined(SHA1_HWACCEL_X86) && defined(_MSC_VER)
+    int info[4];
+#elif defined(SHA1_HWACCEL_X86)
+    unsigned int eax, ebx, ecx, edx;
+#endif
+
+    func = SHA1CompressGeneric;
+#if defined(SHA1_HWACCEL_X86) && defined(_MSC_VER)
+    /* require SSSE3 and SSE4.1 (CPUID.1:ECX[9,19]) plus SHA (CPUID.7.0:EBX[29]) */
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+        __cpuid(info, 1);
+        if ((info[2] & (1 << 9)) && (info[2] & (1 << 19))) {
+            __cpuidex(info, 7, 0);
+            if (info[1] & (1 << 29))
+                func = SHA1CompressX86;
+        }
+    }
+#elif defined(SHA1_HWACCEL_X86)
+    /* require SSSE3 and SSE4.1 (CPUID.1:ECX[9,19]) plus SHA (CPUID.7.0:EBX[29]) */
+    if (__get_cpuid_max(0, NULL) >= 7) {
+        __cpuid(1, eax, ebx, ecx, edx);
+        if ((ecx & (1U << 9)) && (ecx & (1U << 19))) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            if (ebx & (1U << 29))
+                func = SHA1CompressX86;
+        }
+    }
+#elif defined(SHA1_HWACCEL_ARM)
+    /* instructions are guaranteed by the compilation target */
+    func = SHA1CompressARM;
+#endif
 
+    SHA1Compress = func;
+    func(H, data, blocks);
     return;
 }
 
@@ -0,0 +1,717 @@
+/*
+**  OSSP uuid - Universally Unique Identifier
+**  Copyright (c) 2004-2008 Ralf S. Engelschall <rse@engelschall.com>
+**  Copyright (c) 2004-2008 The OSSP Project <http://www.ossp.org/>
+**
+**  This file is part of OSSP uuid, a library for the generation
+**  of UUIDs which can found at http://www.ossp.org/pkg/lib/uuid/
+**
+**  Permission to use, copy, modify, and distribute this software for
+**  any purpose with or without fee is hereby granted, provided that
+**  the above copyright notice and this permission notice appear in all
+**  copies.
+**
+**  THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+**  WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+**  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+**  IN NO EVENT SHALL THE AUTHORS AND COPYRIGHT HOLDERS AND THEIR
+**  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+**  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+**  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+**  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+**  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+**  OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+**  SUCH DAMAGE.
+**
+**  uuid_stress.c: uniqueness and monotonicity stress harness
+*/
+
+/* own headers */
+#include "uuid.h"
+#include "uuid_ac.h"
+#include "uuid_time.h"
+
+/* system headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+
+/* records per buffer of a generator thread and shard */
+#define STRESS_BUF 1024
+
+/* interval of the clock stepping thread (ms) */
+#define STRESS_STEP_MS 100
+
+/* error handler */
+static void
+error(int ec, const char *str, ...)
+{
+    va_list ap;
+
+    va_start(ap, str);
+    fprintf(stderr, "uuid_stress:ERROR: ");
+    vfprintf(stderr, str, ap);
+    fprintf(stderr, "\n");
+    va_end(ap);
+    exit(ec);
+}
+
+/* usage handler */
+static void
+usage(const char *str, ...)
+{
+    va_list ap;
+
+    va_start(ap, str);
+    if (str != NULL) {
+        fprintf(stderr, "uuid_stress:ERROR: ");
+        vfprintf(stderr, str, ap);
+        fprintf(stderr, "\n");
+    }
+    fprintf(stderr, "usage: uuid_stress [-v version] [-m] [-n count] [-p processes] [-t threads]\n"
+                    "                   [-M megabytes] [-d directory] [-b usec]\n");
+    va_end(ap);
+    exit(1);
+}
+
+/* monotonic time in seconds */
+static double
+now_sec(void)
+{
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == -1)
+        error(1, "clock_gettime: %s", strerror(errno));
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#else
+    struct timeval tv;
+
+    if (gettimeofday(&tv, NULL) == -1)
+        error(1, "gettimeofday: %s", strerror(errno));
+    return (double)tv.tv_sec + (double)tv.tv_usec / 1e6;
+#endif
+}
+
+/*
+ *  CLOCK STEPPING
+ *  (the harness provides the library's system time abstraction
+ *  itself, so that the clock can be stepped backwards at run-time)
+ */
+
+/* current backward offset of the system time (usec) */
+static volatile long clock_offset = 0;
+
+/* number of backward steps taken so far */
+static volatile unsigned long clock_steps = 0;
+
+/* POSIX gettimeofday(2) abstraction (without timezone) */
+int time_gettimeofday(struct timeval *tv)
+{
+    long off;
+
+    if (gettimeofday(tv, NULL) == -1)
+        return -1;
+    if ((off = clock_offset) > 0) {
+        tv->tv_sec  -= off / 1000000;
+        tv->tv_usec -= off % 1000000;
+        if (tv->tv_usec < 0) {
+            tv->tv_sec  -= 1;
+            tv->tv_usec += 1000000;
+        }
+    }
+    return 0;
+}
+
+/* BSD usleep(3) abstraction */
+int time_usleep(long usec)
+{
+    struct timespec ts;
+
+    ts.tv_sec  = usec / 1000000;
+    ts.tv_nsec = (usec % 1000000) * 1000;
+    nanosleep(&ts, NULL);
+    return 0;
+}
+
+/* clock stepping thread: every STRESS_STEP_MS step the clock back */
+static long step_usec = 0;
+static volatile int step_done = 0;
+
+static void *
+stepper(void *ctx)
+{
+    long n;
+
+    (void)ctx;
+    while (!step_done) {
+        for (n = 0; n < STRESS_STEP_MS && !step_done; n++)
+            time_usleep(1000);
+        clock_steps++;
+        clock_offset += step_usec;
+    }
+    return NULL;
+}
+
+/*
+ *  RECORD KEYS
+ *  (UUIDs are stored as a bijective mix of their two 64 bit halves,
+ *  so that equal keys mean equal UUIDs and the leading key bits are
+ *  uniformly distributed for every UUID version -- which makes them
+ *  suitable for sharding and radix bucketing)
+ */
+
+typedef struct {
+    uint64_t k1;
+    uint64_t k2;
+} rec_t;
+
+static uint64_t
+mix64(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static void
+key_from_bin(rec_t *key, const unsigned char *bin)
+{
+    uint64_t a, b;
+    int i;
+
+    a = b = 0;
+    for (i = 0; i < 8; i++) {
+        a = (a << 8) | bin[i];
+        b = (b << 8) | bin[i + 8];
+    }
+    key->k2 = b ^ mix64(a);
+    key->k1 = a ^ mix64(key->k2);
+    return;
+}
+
+static void
+key_to_bin(const rec_t *key, unsigned char *bin)
+{
+    uint64_t a, b;
+    int i;
+
+    a = key->k1 ^ mix64(key->k2);
+    b = key->k2 ^ mix64(a);
+    for (i = 7; i >= 0; i--) {
+        bin[i]     = (unsigned char)(a & 0xff); a >>= 8;
+        bin[i + 8] = (unsigned char)(b & 0xff); b >>= 8;
+    }
+    return;
+}
+
+static int
+key_cmp(const void *x, const void *y)
+{
+    const rec_t *a = (const rec_t *)x;
+    const rec_t *b = (const rec_t *)y;
+
+    if (a->k1 != b->k1)
+        return (a->k1 < b->k1 ? -1 : 1);
+    if (a->k2 != b->k2)
+        return (a->k2 < b->k2 ? -1 : 1);
+    return 0;
+}
+
+/*
+ *  GENERATION
+ */
+
+/* per-generator results (in memory shared by all processes) */
+typedef struct {
+    uint64_t count;           /* UUIDs generated             */
+    uint64_t backsteps;       /* time went backwards (v1)    */
+    uint64_t violations;      /* monotonicity violations     */
+} gen_stat_t;
+
+/* generation context (set up before forking) */
+typedef struct {
+    unsigned int version;     /* UUID_MAKE_XXX mode          */
+    int          threads;     /* threads per process         */
+    int          shards;      /* number of shards (0 = none) */
+    int          shard_bits;  /* log2(shards)                */
+    int         *fds;         /* shard files                 */
+    rec_t       *mem;         /* in-memory records (no shards) */
+    uint64_t     per;         /* UUIDs per generator         */
+    uint64_t     extra;       /* generators with one more    */
+    gen_stat_t  *stats;       /* per-generator results       */
+} stress_t;
+
+/* one generator thread */
+typedef struct {
+    stress_t *st;
+    int       gen;            /* global generator number     */
+} gen_t;
+
+static void
+shard_flush(int fd, const rec_t *buf, size_t n)
+{
+    const char *cp = (const char *)buf;
+    size_t len = n * sizeof(rec_t);
+    ssize_t w;
+
+    /* O_APPEND writes of one buffer do not interleave on regular files */
+    while (len > 0) {
+        if ((w = write(fd, cp, len)) < 0) {
+            if (errno == EINTR)
+                continue;
+            error(1, "write: %s", strerror(errno));
+        }
+        cp  += w;
+        len -= (size_t)w;
+    }
+    return;
+}
+
+static void *
+generator(void *ctx)
+{
+    gen_t *g = (gen_t *)ctx;
+    stress_t *st = g->st;
+    gen_stat_t *stat = &st->stats[g->gen];
+    unsigned char bin[UUID_LEN_BIN];
+    unsigned char prev_bin[UUID_LEN_BIN];
+    rec_t key, *out, **buf;
+    size_t *fill;
+    uint64_t n, i, t, prev_t;
+    unsigned int clck, prev_clck;
+    unsigned long steps, prev_steps;
+    uuid_t *uuid;
+    uuid_rc_t rc;
+    size_t len;
+    void *vp;
+    int s;
+
+    /* determine the number and location of our UUIDs */
+    n   = st->per + ((uint64_t)g->gen < st->extra ? 1 : 0);
+    out = NULL;
+    buf = NULL;
+    fill = NULL;
+    if (st->shards == 0)
+        out = st->mem + (uint64_t)g->gen * st->per
+              + ((uint64_t)g->gen < st->extra ? (uint64_t)g->gen : st->extra);
+    else {
+        if (   (buf  = (rec_t **)malloc(st->shards * sizeof(rec_t *))) == NULL
+            || (fill = (size_t *)calloc(st->shards, sizeof(size_t))) == NULL)
+            error(1, "malloc: %s", strerror(errno));
+        for (s = 0; s < st->shards; s++)
+            if ((buf[s] = (rec_t *)malloc(STRESS_BUF * sizeof(rec_t))) == NULL)
+                error(1, "malloc: %s", strerror(errno));
+    }
+
+    if ((rc = uuid_create(&uuid)) != UUID_RC_OK)
+        error(1, "uuid_create: %s", uuid_error(rc));
+    prev_t = 0;
+    prev_clck = 0;
+    prev_steps = 0;
+    for (i = 0; i < n; i++) {
+        steps = clock_steps;
+        if ((rc = uuid_make(uuid, st->version)) != UUID_RC_OK)
+            error(1, "uuid_make: %s", uuid_error(rc));
+        vp  = bin;
+        len = sizeof(bin);
+        if ((rc = uuid_export(uuid, UUID_FMT_BIN, &vp, &len)) != UUID_RC_OK)
+            error(1, "uuid_export: %s", uuid_error(rc));
+
+        /* check monotonicity of this generator */
+        if (st->version & UUID_MAKE_V1) {
+            /* 60 bit time; a non-increasing time is only allowed if the
+               clock was stepped back since the previous UUID was made
+               (the library then randomizes the clock sequence, which
+               cannot be told apart from an increment, so the stepping
+               itself is tracked) */
+            t = ((uint64_t)(bin[6] & 0x0f) << 56) | ((uint64_t)bin[7] << 48)
+              | ((uint64_t)bin[4] << 40) | ((uint64_t)bin[5] << 32)
+              | ((uint64_t)bin[0] << 24) | ((uint64_t)bin[1] << 16)
+              | ((uint64_t)bin[2] << 8)  |  (uint64_t)bin[3];
+            clck = ((unsigned int)(bin[8] & 0x3f) << 8) | bin[9];
+            if (i > 0 && t <= prev_t) {
+                stat->backsteps++;
+                if (clock_steps == prev_steps)
+                    stat->violations++;
+                else if (t == prev_t && clck == prev_clck)
+                    stat->violations++;
+            }
+            prev_t = t;
+            prev_clck = clck;
+            prev_steps = steps;
+        }
+        else if (st->version & UUID_MAKE_V7) {
+            /* 48 bit milliseconds plus 12 bit fraction, strictly increasing */
+            t = ((uint64_t)bin[0] << 52) | ((uint64_t)bin[1] << 44)
+              | ((uint64_t)bin[2] << 36) | ((uint64_t)bin[3] << 28)
+              | ((uint64_t)bin[4] << 20) | ((uint64_t)bin[5] << 12)
+              | ((uint64_t)(bin[6] & 0x0f) << 8) | (uint64_t)bin[7];
+            if (i > 0 && t <= prev_t)
+                stat->violations++;
+            prev_t = t;
+        }
+        else if (st->version & UUID_MAKE_ULID) {
+            /* 48 bit milliseconds plus 80 bit random part, strictly increasing */
+            if (i > 0 && memcmp(bin, prev_bin, UUID_LEN_BIN) <= 0)
+                stat->violations++;
+            memcpy(prev_bin, bin, UUID_LEN_BIN);
+        }
+
+        /* store record */
+        key_from_bin(&key, bin);
+        if (out != NULL)
+            out[i] = key;
+        else {
+            s = (st->shard_bits > 0 ? (int)(key.k1 >> (64 - st->shard_bits)) : 0);
+            buf[s][fill[s]++] = key;
+            if (fill[s] == STRESS_BUF) {
+                shard_flush(st->fds[s], buf[s], fill[s]);
+                fill[s] = 0;
+            }
+        }
+    }
+    stat->count = n;
+    if ((rc = uuid_destroy(uuid)) != UUID_RC_OK)
+        error(1, "uuid_destroy: %s", uuid_error(rc));
+
+    if (buf != NULL) {
+        for (s = 0; s < st->shards; s++) {
+            if (fill[s] > 0)
+                shard_flush(st->fds[s], buf[s], fill[s]);
+            free(buf[s]);
+        }
+        free(buf);
+        free(fill);
+    }
+    return NULL;
+}
+
+/* one generator process: run all its threads (and the clock stepper) */
+static void
+process(stress_t *st, int proc)
+{
+    pthread_t *tid, step_tid;
+    gen_t *gen;
+    int i;
+
+    if (   (tid = (pthread_t *)malloc(st->threads * sizeof(pthread_t))) == NULL
+        || (gen = (gen_t *)malloc(st->threads * sizeof(gen_t))) == NULL)
+        error(1, "malloc: %s", strerror(errno));
+    if (step_usec > 0)
+        if ((errno = pthread_create(&step_tid, NULL, stepper, NULL)) != 0)
+            error(1, "pthread_create: %s", strerror(errno));
+    for (i = 0; i < st->threads; i++) {
+        gen[i].st  = st;
+        gen[i].gen = proc * st->threads + i;
+        if ((errno = pthread_create(&tid[i], NULL, generator, &gen[i])) != 0)
+            error(1, "pthread_create: %s", strerror(errno));
+    }
+    for (i = 0; i < st->threads; i++)
+        pthread_join(tid[i], NULL);
+    if (step_usec > 0) {
+        step_done = 1;
+        pthread_join(step_tid, NULL);
+    }
+    free(gen);
+    free(tid);
+    return;
+}
+
+/*
+ *  VERIFICATION
+ */
+
+/* find duplicates in n records: bucket them by their leading key bits
+   (after the shard bits) into tmp, then sort and scan each bucket */
+static uint64_t
+verify(rec_t *rec, rec_t *tmp, size_t n, int skip_bits)
+{
+    unsigned char bin[UUID_LEN_BIN];
+    size_t *count, nb, b, i, j, beg, end;
+    uint64_t dups;
+    int bits;
+    rec_t k;
+
+    /* about 16 records per bucket */
+    for (bits = 0; bits < 24 && ((size_t)1 << bits) * 16 < n; bits++)
+        ;
+    nb = (size_t)1 << bits;
+    if ((count = (size_t *)calloc(nb + 1, sizeof(size_t))) == NULL)
+        error(1, "malloc: %s", strerror(errno));
+#define BUCKET(r) (bits == 0 ? 0 : (size_t)(((r).k1 << skip_bits) >> (64 - bits)))
+    for (i = 0; i < n; i++)
+        count[BUCKET(rec[i]) + 1]++;
+    for (b = 0; b < nb; b++)
+        count[b + 1] += count[b];
+    for (i = 0; i < n; i++)
+        tmp[count[BUCKET(rec[i])]++] = rec[i];
+#undef BUCKET
+
+    /* after the distribution count[b] is the end of bucket b */
+    dups = 0;
+    beg = 0;
+    for (b = 0; b < nb; b++) {
+        end = count[b];
+        if (end - beg > 1) {
+            if (end - beg <= 16) {
+                /* insertion sort */
+                for (i = beg + 1; i < end; i++) {
+                    k = tmp[i];
+                    for (j = i; j > beg && key_cmp(&tmp[j - 1], &k) > 0; j--)
+                        tmp[j] = tmp[j - 1];
+                    tmp[j] = k;
+                }
+            }
+            else
+                qsort(tmp + beg, end - beg, sizeof(rec_t), key_cmp);
+            for (i = beg + 1; i < end; i++) {
+                if (key_cmp(&tmp[i - 1], &tmp[i]) == 0) {
+                    if (dups < 10) {
+                        key_to_bin(&tmp[i], bin);
+                        fprintf(stderr, "uuid_stress: DUPLICATE: "
+                                "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x\n",
+                                bin[0], bin[1], bin[2],  bin[3],  bin[4],  bin[5],  bin[6],  bin[7],
+                                bin[8], bin[9], bin[10], bin[11], bin[12], bin[13], bin[14], bin[15]);
+                    }
+                    dups++;
+                }
+            }
+        }
+        beg = end;
+    }
+    free(count);
+    return dups;
+}
+
+/* main procedure */
+int main(int argc, char *argv[])
+{
+    stress_t st;
+    char path[1024];
+    const char *dir;
+    unsigned long long count;
+    long mem_mb;
+    int procs;
+    int gens;
+    uint64_t dups, viol, back, total;
+    double t0, t_gen, t_ver;
+    rec_t *rec, *tmp;
+    struct stat sb;
+    pid_t *pid;
+    size_t n, cap;
+    char *p;
+    int ch, i, s, status, fail;
+
+    /* command line parsing */
+    memset(&st, 0, sizeof(st));
+    st.version = UUID_MAKE_V1;
+    st.threads = 1;
+    count  = 1000000;   /* default number of UUIDs */
+    procs  = 1;         /* default is one process */
+    mem_mb = 1024;      /* default memory limit for verification */
+    dir    = getenv("TMPDIR");
+    if (dir == NULL)
+        dir = "/tmp";
+    while ((ch = getopt(argc, argv, "v:mn:p:t:M:d:b:h")) != -1) {
+        switch (ch) {
+            case 'v':
+                if (strcmp(optarg, "ulid") == 0) {
+                    st.version = (st.version & UUID_MAKE_MC) | UUID_MAKE_ULID;
+                    break;
+                }
+                i = strtol(optarg, &p, 10);
+                if (*p != '\0')
+                    usage("invalid argument to option 'v'");
+                switch (i) {
+                    case 1: st.version = (st.version & UUID_MAKE_MC) | UUID_MAKE_V1; break;
+                    case 4: st.version = (st.version & UUID_MAKE_MC) | UUID_MAKE_V4; break;
+                    case 7: st.version = (st.version & UUID_MAKE_MC) | UUID_MAKE_V7; break;
+                    default:
+                        usage("invalid version on option 'v' (has to be 1, 4, 7 or ulid)");
+                        break;
+                }
+                break;
+            case 'm':
+                st.version |= UUID_MAKE_MC;
+                break;
+            case 'n':
+                count = strtoull(optarg, &p, 10);
+                if (*p != '\0' || count < 1)
+                    usage("invalid argument to option 'n'");
+                break;
+            case 'p':
+                procs = strtol(optarg, &p, 10);
+                if (*p != '\0' || procs < 1)
+                    usage("invalid argument to option 'p'");
+                break;
+            case 't':
+                st.threads = strtol(optarg, &p, 10);
+                if (*p != '\0' || st.threads < 1)
+                    usage("invalid argument to option 't'");
+                break;
+            case 'M':
+                mem_mb = strtol(optarg, &p, 10);
+                if (*p != '\0' || mem_mb < 1)
+                    usage("invalid argument to option 'M'");
+                break;
+            case 'd':
+                dir = optarg;
+                break;
+            case 'b':
+                step_usec = strtol(optarg, &p, 10);
+                if (*p != '\0' || step_usec < 0)
+                    usage("invalid argument to option 'b'");
+                break;
+            case 'h':
+                usage(NULL);
+                break;
+            default:
+                usage("invalid option '%c'", optopt);
+        }
+    }
+    if (optind != argc)
+        usage("invalid number of arguments");
+    if ((unsigned long long)(size_t)count != count)
+        usage("count too large for this platform");
+
+    /* distribute the UUIDs over all generators */
+    gens = procs * st.threads;
+    st.per   = (uint64_t)count / gens;
+    st.extra = (uint64_t)count % gens;
+    st.stats = (gen_stat_t *)mmap(NULL, gens * sizeof(gen_stat_t),
+                                  PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANON, -1, 0);
+    if (st.stats == MAP_FAILED)
+        error(1, "mmap: %s", strerror(errno));
+    memset(st.stats, 0, gens * sizeof(gen_stat_t));
+
+    /* verification needs two records per UUID: keep all of them in
+       shared memory if possible or else spill them into shard files
+       of which each one fits into the memory limit */
+    cap = (size_t)mem_mb * 1024 * 1024 / (2 * sizeof(rec_t));
+    if ((size_t)count <= cap) {
+        st.shards = 0;
+        st.mem = (rec_t *)mmap(NULL, (size_t)count * sizeof(rec_t),
+                               PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANON, -1, 0);
+        if (st.mem == MAP_FAILED)
+            error(1, "mmap: %s", strerror(errno));
+    }
+    else {
+        /* shards get a bit more than the average, so round up generously */
+        for (st.shard_bits = 0, st.shards = 1;
+             (size_t)count / st.shards > cap / 2 && st.shard_bits < 16;
+             st.shard_bits++, st.shards *= 2)
+            ;
+        if ((st.fds = (int *)malloc(st.shards * sizeof(int))) == NULL)
+            error(1, "malloc: %s", strerror(errno));
+        for (s = 0; s < st.shards; s++) {
+            snprintf(path, sizeof(path), "%s/uuid_stress.%ld.%d", dir, (long)getpid(), s);
+            if ((st.fds[s] = open(path, O_RDWR|O_CREAT|O_TRUNC|O_APPEND, 0600)) == -1)
+                error(1, "open: %s: %s", path, strerror(errno));
+        }
+    }
+    fprintf(stderr, "uuid_stress: generating %llu UUIDs with %d process(es) x %d thread(s)%s\n",
+            count, procs, st.threads,
+            (st.shards > 0 ? " into shard files" : " into shared memory"));
+
+    /* generation */
+    t0 = now_sec();
+    if ((pid = (pid_t *)malloc(procs * sizeof(pid_t))) == NULL)
+        error(1, "malloc: %s", strerror(errno));
+    fflush(stdout);
+    fflush(stderr);
+    for (i = 0; i < procs; i++) {
+        if ((pid[i] = fork()) == -1)
+            error(1, "fork: %s", strerror(errno));
+        if (pid[i] == 0) {
+            process(&st, i);
+            _exit(0);
+        }
+    }
+    fail = 0;
+    for (i = 0; i < procs; i++) {
+        if (waitpid(pid[i], &status, 0) == -1)
+            error(1, "waitpid: %s", strerror(errno));
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            fail = 1;
+    }
+    free(pid);
+    if (fail)
+        error(1, "generator process failed");
+    t_gen = now_sec() - t0;
+
+    /* collect the per-generator results */
+    total = viol = back = 0;
+    for (i = 0; i < gens; i++) {
+        total += st.stats[i].count;
+        viol  += st.stats[i].violations;
+        back  += st.stats[i].backsteps;
+    }
+    if (total != (uint64_t)count)
+        error(1, "generated %llu instead of %llu UUIDs", (unsigned long long)total, count);
+
+    /* verification of uniqueness */
+    t0 = now_sec();
+    dups = 0;
+    if (st.shards == 0) {
+        if ((tmp = (rec_t *)malloc((size_t)count * sizeof(rec_t))) == NULL)
+            error(1, "malloc: %s", strerror(errno));
+        dups = verify(st.mem, tmp, (size_t)count, 0);
+        free(tmp);
+        munmap(st.mem, (size_t)count * sizeof(rec_t));
+    }
+    else {
+        for (s = 0; s < st.shards; s++) {
+            if (fstat(st.fds[s], &sb) == -1)
+                error(1, "fstat: %s", strerror(errno));
+            n = (size_t)sb.st_size / sizeof(rec_t);
+            if (   (rec = (rec_t *)malloc(n * sizeof(rec_t) + 1)) == NULL
+                || (tmp = (rec_t *)malloc(n * sizeof(rec_t) + 1)) == NULL)
+                error(1, "malloc: %s (shard %d of %lu records)", strerror(errno), s, (unsigned long)n);
+            if (pread(st.fds[s], rec, n * sizeof(rec_t), 0) != (ssize_t)(n * sizeof(rec_t)))
+                error(1, "pread: %s", strerror(errno));
+            dups += verify(rec, tmp, n, st.shard_bits);
+            free(tmp);
+            free(rec);
+            close(st.fds[s]);
+            snprintf(path, sizeof(path), "%s/uuid_stress.%ld.%d", dir, (long)getpid(), s);
+            unlink(path);
+        }
+        free(st.fds);
+    }
+    t_ver = now_sec() - t0;
+    munmap(st.stats, gens * sizeof(gen_stat_t));
+
+    /* report */
+    fprintf(stdout, "version:     %s%s\n",
+            (st.version & UUID_MAKE_V1 ? "1" : (st.version & UUID_MAKE_V4 ? "4" :
+            (st.version & UUID_MAKE_V7 ? "7" : "ulid"))),
+            (st.version & UUID_MAKE_MC ? " (multicast)" : ""));
+    fprintf(stdout, "generators:  %d (%d process(es) x %d thread(s))\n", gens, procs, st.threads);
+    fprintf(stdout, "uuids:       %llu\n", count);
+    fprintf(stdout, "generation:  %.3f sec (%.0f UUIDs/sec)\n", t_gen, (double)count / t_gen);
+    fprintf(stdout, "verification: %.3f sec (%d shard(s))\n", t_ver, (st.shards > 0 ? st.shards : 1));
+    if (step_usec > 0)
+        fprintf(stdout, "clock steps: %ld usec back every %d msec\n", step_usec, STRESS_STEP_MS);
+    if (st.version & UUID_MAKE_V1)
+        fprintf(stdout, "backsteps:   %llu\n", (unsigned long long)back);
+    fprintf(stdout, "monotonic:   %s (%llu violations)\n",
+            (viol == 0 ? "OK" : "FAILED"), (unsigned long long)viol);
+    fprintf(stdout, "unique:      %s (%llu duplicates)\n",
+            (dups == 0 ? "OK" : "FAILED"), (unsigned long long)dups);
+
+    return (dups == 0 && viol == 0 ? 0 : 1);
+}
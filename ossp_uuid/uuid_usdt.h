@@ -0,0 +1,71 @@
+/*
+**  OSSP uuid - Universally Unique Identifier
+**  Copyright (c) 2004-2008 Ralf S. Engelschall <rse@engelschall.com>
+**  Copyright (c) 2004-2008 The OSSP Project <http://www.ossp.org/>
+**
+**  This file is part of OSSP uuid, a library for the generation
+**  of UUIDs which can found at http://www.ossp.org/pkg/lib/uuid/
+**
+**  Permission to use, copy, modify, and distribute this software for
+**  any purpose with or without fee is hereby granted, provided that
+**  the above copyright notice and this permission notice appear in all
+**  copies.
+**
+**  THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+**  WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+**  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+**  IN NO EVENT SHALL THE AUTHORS AND COPYRIGHT HOLDERS AND THEIR
+**  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+**  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+**  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+**  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+**  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+**  OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+**  SUCH DAMAGE.
+**
+**  uuid_usdt.h: static tracepoint (USDT) probes
+*/
+
+#ifndef __UUID_USDT_H__
+#define __UUID_USDT_H__
+
+/*
+ *  Statically-Defined Tracing (USDT) Probes
+ *
+ *  Compiled in only if WITH_USDT is defined (e.g. via "make
+ *  CPPFLAGS=-DWITH_USDT") and <sys/sdt.h> from SystemTap (Linux) or
+ *  DTrace (FreeBSD, Solaris, MacOS X) is available. The probes then
+ *  cost a single no-op instruction when not attached and can be
+ *  enabled from outside with e.g. bpftrace(8), perf(1), stap(1) or
+ *  dtrace(1) as "ossp_uuid:<name>". Otherwise they expand to nothing.
+ *
+ *  Provider "ossp_uuid" probes and their arguments:
+ *  make__entry         (mode)
+ *  make__return        (mode, rc)
+ *  prng__read__entry   (bytes requested)
+ *  prng__read__error   (consecutive retries)
+ *  prng__read__return  (bytes read from device, consecutive retries)
+ *  prng__fallback      (bytes to generate by libc PRNG)
+ *  v1__stall           (time sequence, retries during this call)
+ *  v1__backstep        (old clock sequence)
+ *  mac__entry          ()
+ *  mac__return         (found)
+ */
+
+#if defined(WITH_USDT)
+#include <sys/sdt.h>
+#define UUID_PROBE0(name) \
+    DTRACE_PROBE(ossp_uuid, name)
+#define UUID_PROBE1(name,a1) \
+    DTRACE_PROBE1(ossp_uuid, name, a1)
+#define UUID_PROBE2(name,a1,a2) \
+    DTRACE_PROBE2(ossp_uuid, name, a1, a2)
+#else
+#define UUID_PROBE0(name)       /* no-op */
+#define UUID_PROBE1(name,a1)    /* no-op */
+#define UUID_PROBE2(name,a1,a2) /* no-op */
+#endif
+
+#endif /* __UUID_USDT_H__ */
+